@@ -0,0 +1,73 @@
+#include <cstddef>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <wujihandcpp/data/hand.hpp>
+#include <wujihandcpp/device/hand.hpp>
+#include <wujihandcpp/device/latch.hpp>
+
+using namespace wujihandcpp;
+
+namespace {
+
+constexpr int warmup_count = 100;
+constexpr int sample_count = 2000;
+
+void print(std::vector<double>& samples, const char* name) {
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        return samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))];
+    };
+    std::cout << name << ": p50 " << percentile(0.5) << " us, p90 " << percentile(0.9)
+              << " us, p99 " << percentile(0.99) << " us, max " << samples.back() << " us\n";
+}
+
+// Times `sample_count` synchronous SDO reads and prints latency percentiles in microseconds.
+void measure(device::Hand& hand, const char* name) {
+    auto joint = hand.finger(1).joint(0);
+    for (int i = 0; i < warmup_count; i++)
+        joint.read<data::joint::ActualPosition>();
+
+    std::vector<double> samples;
+    samples.reserve(sample_count);
+    for (int i = 0; i < sample_count; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        joint.read<data::joint::ActualPosition>();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+
+    print(samples, name);
+}
+
+// Times `emergency_stop` while the scheduler is busy with queued reads of every joint.
+void measure_emergency_stop(device::Hand& hand) {
+    constexpr int stop_count = 200;
+    std::vector<double> samples;
+    samples.reserve(stop_count);
+    for (int i = 0; i < stop_count; i++) {
+        device::Latch latch;
+        hand.read_async<data::joint::ActualPosition>(latch);
+        auto latency = hand.emergency_stop();
+        samples.push_back(std::chrono::duration<double, std::micro>(latency).count());
+        latch.wait();
+    }
+    print(samples, "Emergency stop");
+}
+
+} // namespace
+
+int main() {
+    device::Hand hand;
+
+    device::Latch::set_spin_limit(std::chrono::steady_clock::duration::zero());
+    measure(hand, "Blocking wait");
+
+    device::Latch::set_spin_limit(std::chrono::microseconds(200));
+    measure(hand, "Spin-then-block wait");
+
+    measure_emergency_stop(hand);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+/*
+ * C interface for language bindings. Every call works on a batch of joints, so that a binding
+ * crosses the language boundary once per control cycle instead of once per joint.
+ *
+ * Joint values are passed as arrays of WUJIHAND_JOINT_COUNT doubles, indexed by
+ * `finger * 4 + joint`. A mask selects the joints an operation applies to, with the same bit
+ * layout. Values the joint data cannot hold, and NaN, fail with WUJIHAND_ERROR_INVALID_ARGUMENT.
+ * All functions return a wujihand_status; `wujihand_last_error` describes the last failure on
+ * the calling thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "wujihandcpp/utility/api.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented on incompatible changes of this interface. */
+#define WUJIHAND_ABI_VERSION 1
+
+#define WUJIHAND_JOINT_COUNT 20
+#define WUJIHAND_ALL_JOINTS 0xFFFFFu
+
+/*
+ * Timeouts are given in microseconds. Any negative value selects the default of the call, as
+ * in the C++ API: 500 ms for operations, 100 ms for wujihand_emergency_stop and no wait for
+ * wujihand_poll_completions. WUJIHAND_INFINITE_TIMEOUT waits without limit, except in
+ * wujihand_emergency_stop, which never waits longer than one second.
+ */
+#define WUJIHAND_DEFAULT_TIMEOUT (-1)
+#define WUJIHAND_INFINITE_TIMEOUT INT64_MAX
+
+typedef struct wujihand_hand wujihand_hand;
+
+typedef enum wujihand_status {
+    WUJIHAND_OK = 0,
+    WUJIHAND_ERROR_INVALID_ARGUMENT = -1,
+    WUJIHAND_ERROR_TIMEOUT = -2,
+    WUJIHAND_ERROR_SDO = -3, /* Rejected by the device with an SDO error */
+    WUJIHAND_ERROR_FAILED = -4,
+} wujihand_status;
+
+typedef enum wujihand_joint_data {
+    WUJIHAND_JOINT_HARDWARE_VERSION = 0,
+    WUJIHAND_JOINT_HARDWARE_DATE = 1,
+    WUJIHAND_JOINT_CONTROL_MODE = 2,
+    WUJIHAND_JOINT_SIN_LEVEL = 3,
+    WUJIHAND_JOINT_CURRENT_LIMIT = 4,
+    WUJIHAND_JOINT_BUS_VOLTAGE = 5,
+    WUJIHAND_JOINT_TEMPERATURE = 6,
+    WUJIHAND_JOINT_RESET_ERROR = 7,
+    WUJIHAND_JOINT_ERROR_CODE = 8,
+    WUJIHAND_JOINT_ENABLED = 9,
+    WUJIHAND_JOINT_ACTUAL_POSITION = 10,
+    WUJIHAND_JOINT_TARGET_POSITION = 11,
+    WUJIHAND_JOINT_UPPER_LIMIT = 12,
+    WUJIHAND_JOINT_LOWER_LIMIT = 13,
+} wujihand_joint_data;
+
+typedef struct wujihand_completion {
+    uint64_t token;
+    uint32_t error_code; /* SDO error code, 0 if none */
+    uint8_t success;
+} wujihand_completion;
+
+/* One read or write of a mixed batch, see `wujihand_execute`. */
+typedef struct wujihand_item {
+    int32_t data;  /* wujihand_joint_data */
+    int32_t joint; /* finger * 4 + joint */
+    uint8_t write;
+    double value; /* The value to write; for reads, the value read */
+
+    /* Filled in by `wujihand_execute`. */
+    uint8_t success;
+    uint32_t error_code;
+} wujihand_item;
+
+WUJIHANDCPP_API int32_t wujihand_abi_version(void);
+
+/* Message of the last failed call on this thread, valid until the next call. */
+WUJIHANDCPP_API const char* wujihand_last_error(void);
+
+/* `serial_number` may be NULL, `usb_pid` -1 to match any. */
+WUJIHANDCPP_API int32_t wujihand_open(
+    const char* serial_number, int32_t usb_pid, uint16_t usb_vid, wujihand_hand** hand);
+
+WUJIHANDCPP_API void wujihand_close(wujihand_hand* hand);
+
+/* Reads the masked joints from the device into the cache. */
+WUJIHANDCPP_API int32_t
+    wujihand_read(wujihand_hand* hand, int32_t data, uint32_t mask, int64_t timeout_us);
+
+/*
+ * Copies the cached values of all joints. The copy never overlaps a received frame, but values
+ * that arrived in different frames may come from different reads.
+ */
+WUJIHANDCPP_API int32_t wujihand_get(wujihand_hand* hand, int32_t data, double* values);
+
+WUJIHANDCPP_API int32_t wujihand_write(
+    wujihand_hand* hand, int32_t data, uint32_t mask, const double* values, int64_t timeout_us);
+
+/* Streams setpoints: supersedes pending writes and reports no completion. */
+WUJIHANDCPP_API int32_t wujihand_write_unchecked(
+    wujihand_hand* hand, int32_t data, uint32_t mask, const double* values, int64_t timeout_us);
+
+/* Submit without blocking. One completion per call is reported with `token`. */
+WUJIHANDCPP_API int32_t wujihand_read_async(
+    wujihand_hand* hand, int32_t data, uint32_t mask, int64_t timeout_us, uint64_t token);
+
+WUJIHANDCPP_API int32_t wujihand_write_async(
+    wujihand_hand* hand, int32_t data, uint32_t mask, const double* values, int64_t timeout_us,
+    uint64_t token);
+
+/*
+ * Collects up to `max_count` completions, waiting up to `timeout_us` for the first one.
+ * Returns the number collected, or a negative wujihand_status. Call from one thread at a time:
+ * concurrent calls on the same hand are not supported.
+ */
+WUJIHANDCPP_API int64_t wujihand_poll_completions(
+    wujihand_hand* hand, wujihand_completion* completions, size_t max_count, int64_t timeout_us);
+
+/* Executes reads and writes of any data on any joints in the same frames. */
+WUJIHANDCPP_API int32_t
+    wujihand_execute(wujihand_hand* hand, wujihand_item* items, size_t count, int64_t timeout_us);
+
+/*
+ * Disables all joints with one frame sent at once, ahead of queued operations. `timeout_us`
+ * bounds the wait for the frame to leave the host. `latency_us` may be NULL.
+ */
+WUJIHANDCPP_API int32_t
+    wujihand_emergency_stop(wujihand_hand* hand, int64_t timeout_us, int64_t* latency_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 
+#include <limits>
+
 #include "wujihandcpp/protocol/handler.hpp"
 #include "wujihandcpp/utility/api.hpp"
 
@@ -50,6 +53,80 @@ struct WriteOnlyData {
     }
 };
 
+// Conversions between values of data types and raw device values, selected at compile time by
+// the kind of policy (see `conversion_kind`). `policy` carries what is only known at runtime: the
+// direction of reversed joints.
+template <uint32_t kind>
+struct Conversion {
+    template <typename ValueType>
+    static protocol::Handler::Buffer8 to_raw(const ValueType& value, uint32_t) {
+        return protocol::Handler::Buffer8{value};
+    }
+
+    template <typename ValueType>
+    static ValueType from_raw(protocol::Handler::Buffer8 raw, uint32_t) {
+        return raw.as<ValueType>();
+    }
+};
+
+template <>
+struct Conversion<StorageInfo::CONTROL_WORD> {
+    static protocol::Handler::Buffer8 to_raw(bool enabled, uint32_t) {
+        return protocol::Handler::Buffer8{static_cast<uint16_t>(enabled ? 1 : 5)};
+    }
+
+    template <typename ValueType>
+    static ValueType from_raw(protocol::Handler::Buffer8 raw, uint32_t) {
+        return raw.as<uint16_t>() == 1;
+    }
+};
+
+namespace internal {
+
+// Angles map one turn onto the full int32 range; angular velocities, one turn per second.
+template <uint32_t reversed>
+struct AngleConversion {
+    static protocol::Handler::Buffer8 to_raw(double value, uint32_t policy) {
+        if (policy & reversed)
+            value = -value;
+        double raw = std::round(value * (std::numeric_limits<int32_t>::max() / (2 * pi)));
+        if (raw < std::numeric_limits<int32_t>::min())
+            raw = std::numeric_limits<int32_t>::min();
+        else if (raw > std::numeric_limits<int32_t>::max())
+            raw = std::numeric_limits<int32_t>::max();
+        return protocol::Handler::Buffer8{static_cast<int32_t>(raw)};
+    }
+
+    template <typename ValueType>
+    static ValueType from_raw(protocol::Handler::Buffer8 raw, uint32_t policy) {
+        double value = raw.as<int32_t>() * (2 * pi / std::numeric_limits<int32_t>::max());
+        return (policy & reversed) ? -value : value;
+    }
+
+    static constexpr double pi = 3.14159265358979323846;
+};
+
+} // namespace internal
+
+template <>
+struct Conversion<StorageInfo::POSITION>
+    : internal::AngleConversion<StorageInfo::POSITION_REVERSED> {};
+
+template <>
+struct Conversion<StorageInfo::VELOCITY>
+    : internal::AngleConversion<StorageInfo::VELOCITY_REVERSED> {};
+
+// The policy bits that select a conversion. They do not depend on the joint, unlike the
+// direction bits.
+template <typename Data>
+constexpr uint32_t conversion_kind() {
+    return Data::info(0).policy
+         & (StorageInfo::CONTROL_WORD | StorageInfo::POSITION | StorageInfo::VELOCITY);
+}
+
+template <typename Data>
+using ConversionOf = Conversion<conversion_kind<Data>()>;
+
 struct alignas(uint32_t) FirmwareVersionData {
     FirmwareVersionData() = default;
 
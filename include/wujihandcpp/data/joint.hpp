@@ -50,6 +50,11 @@ static constexpr uint32_t position_policy(uint64_t i) {
                                 : (StorageInfo::POSITION);
 }
 
+static constexpr uint32_t velocity_policy(uint64_t i) {
+    return is_reversed_joint(i) ? (StorageInfo::VELOCITY | StorageInfo::VELOCITY_REVERSED)
+                                : (StorageInfo::VELOCITY);
+}
+
 } // namespace internal
 
 struct ActualPosition : ReadOnlyData<device::Joint, 0x64, 0, double> {
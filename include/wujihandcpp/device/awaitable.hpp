@@ -0,0 +1,185 @@
+#pragma once
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+# define SDK_HAS_COROUTINES 1
+#else
+# define SDK_HAS_COROUTINES 0
+#endif
+
+#if SDK_HAS_COROUTINES
+
+# include <cstddef>
+# include <cstdint>
+
+# include <chrono>
+# include <condition_variable>
+# include <coroutine>
+# include <deque>
+# include <mutex>
+# include <type_traits>
+
+# include "wujihandcpp/data/helper.hpp"
+# include "wujihandcpp/device/latch.hpp"
+# include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+// Decides where a coroutine awaiting a hand operation resumes.
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    // Called on the thread that completed the operation, usually the internal tick thread, so
+    // it must return quickly.
+    virtual void post(std::coroutine_handle<> continuation) = 0;
+};
+
+// Resumes coroutines directly on the thread that completed the operation. Slow continuations
+// delay the hand.
+class InlineExecutor final : public Executor {
+public:
+    void post(std::coroutine_handle<> continuation) override { continuation.resume(); }
+};
+
+// Resumes coroutines on the threads that call `run_for`, such as an application event loop.
+class QueueExecutor final : public Executor {
+public:
+    void post(std::coroutine_handle<> continuation) override {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            continuations_.push_back(continuation);
+        }
+        condition_.notify_one();
+    }
+
+    // Resumes the queued coroutines, waiting up to `timeout` for the first one. Returns the
+    // number resumed.
+    size_t run_for(std::chrono::steady_clock::duration timeout) {
+        size_t count = 0;
+        std::unique_lock<std::mutex> lock{mutex_};
+        condition_.wait_for(lock, timeout, [this]() { return !continuations_.empty(); });
+        while (!continuations_.empty()) {
+            auto continuation = continuations_.front();
+            continuations_.pop_front();
+            lock.unlock();
+            continuation.resume();
+            count++;
+            lock.lock();
+        }
+        return count;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::coroutine_handle<>> continuations_;
+};
+
+namespace internal {
+
+template <typename Data>
+struct AwaitResult {
+    using type = typename Data::ValueType;
+};
+
+template <>
+struct AwaitResult<void> {
+    using type = void;
+};
+
+} // namespace internal
+
+// Awaiter of an operation on `count` storage units. Submitting is deferred to `await_suspend`,
+// and the awaiter lives in the coroutine frame until it resumes, so it serves as the callback
+// context. Resumes with the value of `Data` for single reads, with nothing otherwise, and throws
+// like `Latch::wait` on failure.
+template <typename Data, int count>
+class OperationAwaitable {
+public:
+    using Handler = protocol::Handler;
+    using Buffer8 = protocol::Handler::Buffer8;
+    using Result = typename internal::AwaitResult<Data>::type;
+
+    OperationAwaitable(
+        Handler& handler, Executor& executor, std::chrono::steady_clock::duration timeout)
+        : handler_(handler)
+        , executor_(executor)
+        , timeout_(timeout) {}
+
+    // Must not move once awaited.
+    OperationAwaitable(OperationAwaitable&&) = default;
+    OperationAwaitable& operator=(OperationAwaitable&&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> continuation) {
+        continuation_ = continuation;
+        // The operation may complete, and resume the coroutine, before this returns.
+        if (write_)
+            submit_write();
+        else
+            submit_read();
+    }
+
+    Result await_resume() const {
+        if (!success_) {
+            if (error_code_)
+                Latch::throw_sdo_error(1, error_code_);
+            throw TimeoutError("Operation timed out while waiting for completion");
+        }
+        if constexpr (!std::is_void<Result>::value)
+            return data::ConversionOf<Data>::template from_raw<Result>(
+                handler_.get(storage_ids_[0]), policy_);
+    }
+
+private:
+    template <typename T>
+    friend class DataOperator;
+
+    void submit_read() {
+        if (count == 1)
+            handler_.read_async(storage_ids_[0], timeout_.count(), complete, Buffer8{this});
+        else
+            handler_.read_async_bulk(
+                storage_ids_, count, timeout_.count(), complete, Buffer8{this});
+    }
+
+    void submit_write() {
+        if (count == 1)
+            handler_.write_async(
+                raw_values_[0], storage_ids_[0], timeout_.count(), complete, Buffer8{this},
+                confirmation_);
+        else
+            handler_.write_async_bulk(
+                raw_values_, storage_ids_, count, timeout_.count(), complete, Buffer8{this},
+                confirmation_);
+    }
+
+    static void complete(Buffer8 context, bool success, uint32_t error_code) {
+        auto& self = *context.as<OperationAwaitable*>();
+        self.success_ = success;
+        self.error_code_ = error_code;
+        self.executor_.post(self.continuation_);
+    }
+
+    Handler& handler_;
+    Executor& executor_;
+    std::chrono::steady_clock::duration timeout_;
+
+    int storage_ids_[count];
+    uint32_t policy_ = 0;
+
+    bool write_ = false;
+    Handler::WriteConfirmation confirmation_ = Handler::WriteConfirmation::DEFAULT;
+    Buffer8 raw_values_[count];
+
+    std::coroutine_handle<> continuation_;
+    bool success_ = false;
+    uint32_t error_code_ = 0;
+};
+
+} // namespace device
+} // namespace wujihandcpp
+
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+// Identifies an operation whose completion is delivered to the completion queue instead of a
+// callback, see `Hand::poll_completions`.
+struct CompletionToken {
+    uint64_t value;
+};
+
+using Completion = protocol::Handler::Completion;
+
+} // namespace device
+} // namespace wujihandcpp
@@ -1,11 +1,21 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+#include <array>
 #include <chrono>
+#include <new>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 
+#include "wujihandcpp/data/helper.hpp"
+#include "wujihandcpp/device/awaitable.hpp"
+#include "wujihandcpp/device/completion.hpp"
 #include "wujihandcpp/device/latch.hpp"
+#include "wujihandcpp/device/selection.hpp"
+#include "wujihandcpp/device/transaction.hpp"
 #include "wujihandcpp/protocol/handler.hpp"
 
 #if __cplusplus >= 202002L
@@ -17,6 +27,16 @@
 namespace wujihandcpp {
 namespace device {
 
+using WriteConfirmation = protocol::Handler::WriteConfirmation;
+
+// A cached value together with the version of the storage unit it was read from. Versions start
+// at 0 (never read) and increase with every successful read.
+template <typename ValueType>
+struct Versioned {
+    ValueType value;
+    uint32_t version;
+};
+
 template <typename T>
 class DataOperator {
     using Handler = protocol::Handler;
@@ -26,23 +46,291 @@ class DataOperator {
     template <typename U>
     friend class DataOperator;
 
+    // The storage ids of `Data` below this operator: `storage_offset_` plus a table built at
+    // compile time, so a selection is a flat loop instead of a walk through `sub`.
     template <typename Data, typename F>
-    typename std::enable_if<std::is_same<typename Data::Base, T>::value>::type iterate(F&& f) {
+    void iterate(F&& f) {
+        constexpr auto offsets =
+            storage_id_offsets<Data>(std::make_integer_sequence<int, storage_count<Data>()>{});
         T& self = *static_cast<T*>(this);
-        f(self.storage_offset_ + T::Datas::template index<Data>());
+        for (int offset : offsets)
+            f(self.storage_offset_ + offset);
     }
 
+    // Also passes the policy of each storage unit, which completes the conversion of `Data`
+    // selected at compile time. `path_` is the position of the operator in the hand.
     template <typename Data, typename F>
-    typename std::enable_if<!std::is_same<typename Data::Base, T>::value>::type iterate(F&& f) {
+    void iterate_with_policy(F&& f) {
+        constexpr auto offsets =
+            storage_id_offsets<Data>(std::make_integer_sequence<int, storage_count<Data>()>{});
         T& self = *static_cast<T*>(this);
-        for (int i = 0; i < T::sub_count_; i++)
-            self.sub(i).template iterate<Data>(f);
+        for (int k = 0; k < storage_count<Data>(); k++)
+            f(self.storage_offset_ + offsets[size_t(k)],
+              Data::info(unit_path<Data>(self.path_, k)).policy);
+    }
+
+    template <typename Data>
+    static Buffer8 to_raw(const typename Data::ValueType& value, uint32_t policy) {
+        return data::ConversionOf<Data>::to_raw(value, policy);
+    }
+
+    template <typename Data>
+    static typename Data::ValueType from_raw(Buffer8 raw, uint32_t policy) {
+        return data::ConversionOf<Data>::template from_raw<typename Data::ValueType>(raw, policy);
+    }
+
+    template <typename Data>
+    static constexpr
+        typename std::enable_if<std::is_same<typename Data::Base, T>::value, int>::type
+        storage_count() {
+        return 1;
+    }
+
+    template <typename Data>
+    static constexpr
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, int>::type
+        storage_count() {
+        return T::sub_count_ * T::Sub::template storage_count<Data>();
+    }
+
+    template <typename Data>
+    static constexpr int storage_count_sum() {
+        return storage_count<Data>();
+    }
+
+    template <typename Data, typename Next, typename... Datas>
+    static constexpr int storage_count_sum() {
+        return storage_count<Data>() + storage_count_sum<Next, Datas...>();
+    }
+
+    template <typename Data>
+    int* collect_storage_ids(int* storage_ids) {
+        iterate<Data>([&storage_ids](int storage_id) { *storage_ids++ = storage_id; });
+        return storage_ids;
+    }
+
+    template <typename Data, typename Next, typename... Datas>
+    int* collect_storage_ids(int* storage_ids) {
+        return collect_storage_ids<Next, Datas...>(collect_storage_ids<Data>(storage_ids));
+    }
+
+    // Reads every storage unit of the given data types with a single completion.
+    template <typename... Datas>
+    void read_async_bulk_internal(
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, std::chrono::steady_clock::duration timeout) {
+        constexpr int count = storage_count_sum<Datas...>();
+        int storage_ids[count];
+        collect_storage_ids<Datas...>(storage_ids);
+
+        read_storage_async(storage_ids, count, callback, callback_context, timeout);
+    }
+
+    void read_storage_async(
+        const int* storage_ids, size_t count,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, std::chrono::steady_clock::duration timeout) {
+        Handler& handler = static_cast<T*>(this)->handler_;
+        if (count == 1)
+            handler.read_async(storage_ids[0], timeout.count(), callback, callback_context);
+        else
+            handler.read_async_bulk(
+                storage_ids, count, timeout.count(), callback, callback_context);
+    }
+
+    template <typename Data>
+    void write_async_bulk_internal(
+        typename Data::ValueType value,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, std::chrono::steady_clock::duration timeout,
+        WriteConfirmation confirmation) {
+        int storage_ids[storage_count<Data>()];
+        Buffer8 raw_values[storage_count<Data>()];
+        int count = 0;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            storage_ids[count] = storage_id;
+            raw_values[count++] = to_raw<Data>(value, policy);
+        });
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        if (storage_count<Data>() == 1)
+            handler.write_async(
+                raw_values[0], storage_ids[0], timeout.count(), callback, callback_context,
+                confirmation);
+        else
+            handler.write_async_bulk(
+                raw_values, storage_ids, storage_count<Data>(), timeout.count(), callback,
+                callback_context, confirmation);
+    }
+
+    // `Data::ValueType` array shaped like the selection of `Data` below this operator, such as
+    // `double[5][4]` for joint data of the hand. Has no `type` for data of the operator itself.
+    template <typename Data, typename U = T, typename = void>
+    struct SelectionArray {};
+
+    template <typename Data, typename U>
+    struct SelectionArray<
+        Data, U,
+        typename std::enable_if<std::is_same<typename Data::Base, typename U::Sub>::value>::type> {
+        using type = typename Data::ValueType[U::sub_count_];
+    };
+
+    template <typename Data, typename U>
+    struct SelectionArray<
+        Data, U,
+        typename std::enable_if<
+            !std::is_same<typename Data::Base, U>::value
+            && !std::is_same<typename Data::Base, typename U::Sub>::value>::type> {
+        using type = typename DataOperator<typename U::Sub>::template SelectionArray<
+            Data>::type[U::sub_count_];
+    };
+
+    template <typename Data>
+    void write_all_internal(
+        const typename Data::ValueType* values, Buffer8* raw_values, int* storage_ids) {
+        int k = 0;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            storage_ids[k] = storage_id;
+            raw_values[k] = to_raw<Data>(values[k], policy);
+            k++;
+        });
+    }
+
+    template <typename... Datas>
+    void subscribe_internal(std::chrono::steady_clock::duration::rep period) {
+        constexpr int count = storage_count_sum<Datas...>();
+        int storage_ids[count];
+        collect_storage_ids<Datas...>(storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        handler.subscribe(storage_ids, count, period);
+    }
+
+    static void count_down_latch(Buffer8 context, bool success, uint32_t error_code) {
+        context.as<Latch*>()->count_down(success, error_code);
+    }
+
+    // User callbacks take either `(bool success)` or `(bool success, uint32_t error_code)`, where
+    // `error_code` is the device SDO error code, or 0 if the operation succeeded or timed out.
+    template <typename F>
+    static auto invoke_callback_internal(F& f, bool success, uint32_t error_code, int)
+        -> decltype(f(success, error_code), void()) {
+        f(success, error_code);
+    }
+
+    template <typename F>
+    static void invoke_callback_internal(F& f, bool success, uint32_t, ...) {
+        f(success);
+    }
+
+    template <typename F>
+    static void invoke_callback(Buffer8 context, bool success, uint32_t error_code) {
+        F f = context.as<F>();
+        invoke_callback_internal(f, success, error_code, 0);
+    }
+
+    using CallbackFunction = void (*)(Buffer8 context, bool success, uint32_t error_code);
+
+    struct BoundCallback {
+        CallbackFunction function;
+        Buffer8 context;
+    };
+
+    template <typename F>
+    static constexpr bool fits_context() {
+        return sizeof(F) <= 8 && alignof(F) <= 8 && std::is_trivially_copyable<F>::value
+            && std::is_trivially_destructible<F>::value;
+    }
+
+    // Small trivially copyable callables travel in the callback context itself.
+    template <typename F>
+    static auto bind_callback(Handler&, F&& f) -> typename std::enable_if<
+        fits_context<typename std::decay<F>::type>(), BoundCallback>::type {
+        using Callable = typename std::decay<F>::type;
+        return BoundCallback{invoke_callback<Callable>, Buffer8{Callable(f)}};
+    }
+
+    // Any other callable is moved into a preallocated completion slot of the handler and
+    // destroyed right after it has been invoked.
+    template <typename F>
+    static auto bind_callback(Handler& handler, F&& f) -> typename std::enable_if<
+        !fits_context<typename std::decay<F>::type>(), BoundCallback>::type {
+        using Callable = typename std::decay<F>::type;
+        using Slot = Handler::CompletionSlot;
+        static_assert(
+            sizeof(Callable) <= Slot::capacity, "Callback is too large for a completion slot");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "");
+
+        Slot* slot = handler.acquire_completion_slot();
+        if (!slot)
+            throw std::runtime_error("Out of completion slots: too many callbacks pending!");
+
+        slot->complete = [](Slot& slot, bool success, uint32_t error_code) {
+            auto& callable = *reinterpret_cast<Callable*>(slot.storage);
+            struct Destroy {
+                Callable& callable;
+                ~Destroy() { callable.~Callable(); }
+            } destroy{callable};
+            invoke_callback_internal(callable, success, error_code, 0);
+        };
+        slot->discard = [](Slot& slot) { reinterpret_cast<Callable*>(slot.storage)->~Callable(); };
+        try {
+            new (slot->storage) Callable(std::forward<F>(f));
+        } catch (...) {
+            slot->discard = [](Slot&) {};
+            Handler::discard_completion_slot(slot);
+            throw;
+        }
+        return BoundCallback{Handler::complete_slot, Buffer8{slot}};
+    }
+
+    // Releases what `bind_callback` holds when the operation could not be submitted.
+    static void unbind_callback(const BoundCallback& callback) {
+        if (callback.function == Handler::complete_slot) {
+            auto slot = callback.context.template as<Handler::CompletionSlot*>();
+            Handler::discard_completion_slot(slot);
+        }
+    }
+
+    // Binds, submits with `submit(function, context)`, and unbinds again if submitting throws.
+    template <typename F, typename Submit>
+    static void submit_with_callback(Handler& handler, F&& f, const Submit& submit) {
+        auto callback = bind_callback(handler, std::forward<F>(f));
+        try {
+            submit(callback.function, callback.context);
+        } catch (...) {
+            unbind_callback(callback);
+            throw;
+        }
+    }
+
+    // Operations on several storage units invoke one copy of the callable per unit; a single
+    // unit takes the callable itself.
+    template <typename F>
+    static F&& pass_callback(F& f, std::true_type) {
+        return std::forward<F>(f);
     }
 
+    template <typename F>
+    static const typename std::decay<F>::type& pass_callback(F& f, std::false_type) {
+        return f;
+    }
+
+    template <typename F>
+    using callback_overload = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, CompletionToken>::value
+        && !std::is_same<typename std::decay<F>::type, Latch>::value>::type;
+
 public:
     static constexpr std::chrono::steady_clock::duration default_timeout =
         std::chrono::milliseconds(500);
 
+    // Pass as the timeout to derive it from the measured round-trip time, so that an unresponsive
+    // device is detected within a few round trips. Falls back to `default_timeout` until the
+    // first measurement.
+    static constexpr std::chrono::steady_clock::duration adaptive_timeout =
+        std::chrono::steady_clock::duration{Handler::adaptive_timeout};
+
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::readable)
     auto read(std::chrono::steady_clock::duration timeout = default_timeout) ->
@@ -72,37 +360,175 @@ public:
     void read_async(Latch& latch, std::chrono::steady_clock::duration timeout = default_timeout) {
         static_assert(Data::readable, "");
 
-        Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            latch.count_up();
+        latch.count_up();
+        read_async_bulk_internal<Data>(count_down_latch, Buffer8{&latch}, timeout);
+    }
+
+    // Completes once for the whole selection, into the completion queue.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    void read_async(
+        CompletionToken token, std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(Data::readable, "");
 
-            Buffer8 callback_context{&latch};
-            handler.read_async(
-                storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { (context.as<Latch*>())->count_down(success); },
-                callback_context);
+        read_async_bulk_internal<Data>(Handler::queue_completion, Buffer8{token.value}, timeout);
+    }
+
+#if SDK_HAS_COROUTINES
+    // Awaitable form: `co_await` it to read without blocking a thread. The coroutine resumes
+    // on `executor` with the value (single objects), or throws like `read`.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read_async(
+        Executor& executor, std::chrono::steady_clock::duration timeout = default_timeout)
+        -> OperationAwaitable<
+            typename std::conditional<
+                std::is_same<typename Data::Base, T>::value, Data, void>::type,
+            storage_count<Data>()> {
+        static_assert(Data::readable, "");
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        OperationAwaitable<
+            typename std::conditional<
+                std::is_same<typename Data::Base, T>::value, Data, void>::type,
+            storage_count<Data>()>
+            awaitable{handler, executor, timeout};
+        int i = 0;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            awaitable.storage_ids_[i++] = storage_id;
+            awaitable.policy_ = policy;
         });
+        return awaitable;
+    }
+
+    template <typename Data1, typename Data2, typename... Datas>
+    auto read_async(
+        Executor& executor, std::chrono::steady_clock::duration timeout = default_timeout)
+        -> OperationAwaitable<void, storage_count_sum<Data1, Data2, Datas...>()> {
+        static_assert(all_readable<Data1, Data2, Datas...>(), "");
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        OperationAwaitable<void, storage_count_sum<Data1, Data2, Datas...>()> awaitable{
+            handler, executor, timeout};
+        collect_storage_ids<Data1, Data2, Datas...>(awaitable.storage_ids_);
+        return awaitable;
+    }
+#endif
+
+    // Reads only the storage units whose cached value is older than `max_age` (or was never
+    // read), so a round trip is paid only when the cached value is really too old.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read_if_older_than(
+        std::chrono::steady_clock::duration max_age,
+        std::chrono::steady_clock::duration timeout = default_timeout) ->
+        typename std::enable_if<
+            std::is_same<typename Data::Base, T>::value, typename Data::ValueType>::type {
+        static_assert(Data::readable, "");
+
+        Latch latch;
+        read_async_if_older_than<Data>(latch, max_age, timeout);
+        latch.wait();
+        return get<Data>();
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    auto read_if_older_than(
+        std::chrono::steady_clock::duration max_age,
+        std::chrono::steady_clock::duration timeout = default_timeout) ->
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, void>::type {
+        static_assert(Data::readable, "");
+
+        Latch latch;
+        read_async_if_older_than<Data>(latch, max_age, timeout);
+        latch.wait();
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    void read_async_if_older_than(
+        Latch& latch, std::chrono::steady_clock::duration max_age,
+        std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(Data::readable, "");
+
+        int storage_ids[storage_count<Data>()];
+        collect_storage_ids<Data>(storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        int stale_storage_ids[storage_count<Data>()];
+        size_t stale_count = handler.select_stale(
+            storage_ids, storage_count<Data>(), max_age.count(), stale_storage_ids);
+        if (!stale_count)
+            return;
+
+        latch.count_up();
+        read_storage_async(
+            stale_storage_ids, stale_count, count_down_latch, Buffer8{&latch}, timeout);
+    }
+
+    template <typename Data1, typename Data2, typename... Datas>
+    void read(std::chrono::steady_clock::duration timeout = default_timeout) {
+        Latch latch;
+        read_async<Data1, Data2, Datas...>(latch, timeout);
+        latch.wait();
+    }
+
+    template <typename Data1, typename Data2, typename... Datas>
+    void read_async(Latch& latch, std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(all_readable<Data1, Data2, Datas...>(), "");
+
+        latch.count_up();
+        read_async_bulk_internal<Data1, Data2, Datas...>(
+            count_down_latch, Buffer8{&latch}, timeout);
+    }
+
+    template <typename Data1, typename Data2, typename... Datas>
+    void read_async(
+        CompletionToken token, std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(all_readable<Data1, Data2, Datas...>(), "");
+
+        read_async_bulk_internal<Data1, Data2, Datas...>(
+            Handler::queue_completion, Buffer8{token.value}, timeout);
+    }
+
+    template <typename Data1, typename Data2, typename... Datas, typename F>
+    SDK_CPP20_REQUIRES(
+        requires(bool success, std::decay_t<F>& f) { f(success); }
+        || requires(bool success, uint32_t error_code, std::decay_t<F>& f) {
+               f(success, error_code);
+           })
+    auto read_async(F&& f, std::chrono::steady_clock::duration timeout = default_timeout)
+        -> callback_overload<F> {
+        static_assert(all_readable<Data1, Data2, Datas...>(), "");
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        submit_with_callback(
+            handler, std::forward<F>(f),
+            [&](CallbackFunction callback, Buffer8 context) {
+                read_async_bulk_internal<Data1, Data2, Datas...>(callback, context, timeout);
+            });
     }
 
     template <typename Data, typename F>
     SDK_CPP20_REQUIRES(
-        Data::readable && sizeof(F) <= 8 && alignof(F) <= 8
-        && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
-        && requires(bool success, const F& f) { f(success); })
-    void read_async(const F& f, std::chrono::steady_clock::duration timeout = default_timeout) {
+        Data::readable
+        && (requires(bool success, std::decay_t<F>& f) { f(success); }
+            || requires(bool success, uint32_t error_code, std::decay_t<F>& f) {
+                   f(success, error_code);
+               }))
+    auto read_async(F&& f, std::chrono::steady_clock::duration timeout = default_timeout)
+        -> callback_overload<F> {
         static_assert(Data::readable, "");
 
-        static_assert(sizeof(F) <= 8, "");
-        static_assert(alignof(F) <= 8, "");
-        static_assert(std::is_trivially_copyable<F>::value, "");
-        static_assert(std::is_trivially_destructible<F>::value, "");
-
         Handler& handler = static_cast<T*>(this)->handler_;
+        std::integral_constant<bool, storage_count<Data>() == 1> single;
         iterate<Data>([&](int storage_id) {
-            Buffer8 callback_context{f};
-            handler.read_async(
-                storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { context.as<F>()(success); }, callback_context);
+            submit_with_callback(
+                handler, pass_callback<F>(f, single),
+                [&](CallbackFunction callback, Buffer8 context) {
+                    handler.read_async(storage_id, timeout.count(), callback, context);
+                });
         });
     }
 
@@ -111,9 +537,31 @@ public:
     void read_async_unchecked(std::chrono::steady_clock::duration timeout = default_timeout) {
         static_assert(Data::readable, "");
 
+        int storage_ids[storage_count<Data>()];
+        collect_storage_ids<Data>(storage_ids);
+
         Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>(
-            [&](int storage_id) { handler.read_async_unchecked(storage_id, timeout.count()); });
+        if (storage_count<Data>() == 1)
+            handler.read_async_unchecked(storage_ids[0], timeout.count());
+        else
+            handler.read_async_unchecked_bulk(
+                storage_ids, storage_count<Data>(), timeout.count());
+    }
+
+    // Polls the given data types in the background: the tick thread issues the reads every
+    // period (spread across ticks) and keeps the cached values returned by `get` up to date.
+    template <typename Data, typename... Datas>
+    void subscribe(std::chrono::steady_clock::duration period) {
+        static_assert(all_readable<Data, Datas...>(), "");
+        if (period <= std::chrono::steady_clock::duration::zero())
+            throw std::invalid_argument("Subscription period must be positive.");
+
+        subscribe_internal<Data, Datas...>(period.count());
+    }
+
+    template <typename Data, typename... Datas>
+    void unsubscribe() {
+        subscribe_internal<Data, Datas...>(0);
     }
 
     template <typename Data>
@@ -122,21 +570,127 @@ public:
 
         Handler& handler = static_cast<T*>(this)->handler_;
         typename Data::ValueType value;
-        iterate<Data>([&](int storage_id) {
-            value = handler.get(storage_id).as<typename Data::ValueType>();
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            value = from_raw<Data>(handler.get(storage_id), policy);
         });
         return value;
     }
 
+    // The time of the last successful read, or the clock's epoch if never read.
+    template <typename Data>
+    auto last_update() -> typename std::enable_if<
+        std::is_same<typename Data::Base, T>::value, std::chrono::steady_clock::time_point>::type {
+        int storage_id;
+        collect_storage_ids<Data>(&storage_id);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        return std::chrono::steady_clock::time_point{
+            std::chrono::steady_clock::duration{handler.get_update_point(storage_id)}};
+    }
+
+    template <typename Data>
+    auto get_with_version() -> typename std::enable_if<
+        std::is_same<typename Data::Base, T>::value,
+        Versioned<typename Data::ValueType>>::type {
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        Versioned<typename Data::ValueType> result;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            result.value =
+                from_raw<Data>(handler.get_with_version(storage_id, result.version), policy);
+        });
+        return result;
+    }
+
+    template <typename Data>
+    auto get_versions() -> typename std::enable_if<
+        !std::is_same<typename Data::Base, T>::value,
+        std::array<uint32_t, storage_count<Data>()>>::type {
+        int storage_ids[storage_count<Data>()];
+        collect_storage_ids<Data>(storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        std::array<uint32_t, storage_count<Data>()> versions;
+        handler.get_versions(storage_ids, versions.size(), versions.data());
+        return versions;
+    }
+
+    // Prepares the storage units of `Data` whose bit is set in `mask`, counted in `iterate` order
+    // (bit `f * 4 + j` for joint `j` of finger `f` below the hand), for repeated operations.
+    template <typename Data>
+    Selection<Data> select(uint32_t mask = ~uint32_t(0)) {
+        static_assert(storage_count<Data>() <= int(Selection<Data>::max_size), "");
+
+        Selection<Data> selection{static_cast<T*>(this)->handler_};
+        int k = 0;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            if (mask & (uint32_t(1) << k))
+                selection.add(storage_id, policy);
+            k++;
+        });
+        return selection;
+    }
+
+    // Copies the cached values of the whole selection, shaped like it: `double[5][4]` for joint
+    // data of the hand. Unlike separate `get` calls, the copy never overlaps a received frame, so
+    // the values of each frame are copied all or none. The replies to a read of the whole hand
+    // may arrive in several frames, though, so the values can still come from different reads.
+    template <typename Data>
+    void get_all(typename SelectionArray<Data>::type& values) {
+        constexpr int count = storage_count<Data>();
+        int storage_ids[count];
+        collect_storage_ids<Data>(storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        Buffer8 raw_values[count];
+        handler.get_consistent(storage_ids, count, raw_values);
+
+        typename Data::ValueType flat[count];
+        int k = 0;
+        iterate_with_policy<Data>([&](int, uint32_t policy) {
+            flat[k] = from_raw<Data>(raw_values[k], policy);
+            k++;
+        });
+        unflatten(values, flat);
+    }
+
+    // Blocks until the cached value moves past `version`, e.g. when a subscription delivers
+    // new data. Returns false on timeout; a negative timeout waits indefinitely.
+    template <typename Data>
+    auto wait_for_update(uint32_t version, std::chrono::steady_clock::duration timeout) ->
+        typename std::enable_if<std::is_same<typename Data::Base, T>::value, bool>::type {
+        int storage_id;
+        collect_storage_ids<Data>(&storage_id);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        return handler.wait_for_update(&storage_id, &version, 1, timeout.count());
+    }
+
+    // Selection form: returns once every storage unit has moved past the versions previously
+    // obtained from `get_versions`.
+    template <typename Data>
+    auto wait_for_update(
+        const std::array<uint32_t, storage_count<Data>()>& versions,
+        std::chrono::steady_clock::duration timeout) ->
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, bool>::type {
+        int storage_ids[storage_count<Data>()];
+        collect_storage_ids<Data>(storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        return handler.wait_for_update(
+            storage_ids, versions.data(), versions.size(), timeout.count());
+    }
+
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::writable)
     void write(
         typename Data::ValueType value,
-        std::chrono::steady_clock::duration timeout = default_timeout) {
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
         static_assert(Data::writable, "");
 
         Latch latch;
-        write_async<Data>(latch, value, timeout);
+        write_async<Data>(latch, value, timeout, confirmation);
         latch.wait();
     }
 
@@ -144,59 +698,267 @@ public:
     SDK_CPP20_REQUIRES(Data::writable)
     void write_async(
         Latch& latch, typename Data::ValueType value,
-        std::chrono::steady_clock::duration timeout = default_timeout) {
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
         static_assert(Data::writable, "");
 
+        latch.count_up();
+        write_async_bulk_internal<Data>(
+            value, count_down_latch, Buffer8{&latch}, timeout, confirmation);
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_async(
+        CompletionToken token, typename Data::ValueType value,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+
+        write_async_bulk_internal<Data>(
+            value, Handler::queue_completion, Buffer8{token.value}, timeout, confirmation);
+    }
+
+    // Writes a value per storage unit of the selection, shaped like `get_all`, in one bulk
+    // operation.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_all(
+        const typename SelectionArray<Data>::type& values,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+
+        Latch latch;
+        write_all_async<Data>(latch, values, timeout, confirmation);
+        latch.wait();
+    }
+
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_all_async(
+        Latch& latch, const typename SelectionArray<Data>::type& values,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+
+        constexpr int count = storage_count<Data>();
+        typename Data::ValueType flat[count];
+        flatten(values, flat);
+        int storage_ids[count];
+        Buffer8 raw_values[count];
+        write_all_internal<Data>(flat, raw_values, storage_ids);
+
         Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            latch.count_up();
+        latch.count_up();
+        handler.write_async_bulk(
+            raw_values, storage_ids, count, timeout.count(), count_down_latch, Buffer8{&latch},
+            confirmation);
+    }
 
-            Buffer8 callback_context{&latch};
-            handler.write_async(
-                Buffer8{value}, storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { (context.as<Latch*>())->count_down(success); },
-                callback_context);
+    // Streams a value per storage unit, superseding pending writes like `write_async_unchecked`.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void write_all_unchecked(
+        const typename SelectionArray<Data>::type& values,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+
+        constexpr int count = storage_count<Data>();
+        typename Data::ValueType flat[count];
+        flatten(values, flat);
+        int storage_ids[count];
+        Buffer8 raw_values[count];
+        write_all_internal<Data>(flat, raw_values, storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        handler.write_async_unchecked_bulk(
+            raw_values, storage_ids, count, timeout.count(), confirmation);
+    }
+
+#if SDK_HAS_COROUTINES
+    // Awaitable form, see the awaitable `read_async`.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    auto write_async(
+        Executor& executor, typename Data::ValueType value,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT)
+        -> OperationAwaitable<void, storage_count<Data>()> {
+        static_assert(Data::writable, "");
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        OperationAwaitable<void, storage_count<Data>()> awaitable{handler, executor, timeout};
+        awaitable.write_ = true;
+        awaitable.confirmation_ = confirmation;
+        int i = 0;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            awaitable.storage_ids_[i] = storage_id;
+            awaitable.raw_values_[i++] = to_raw<Data>(value, policy);
         });
+        return awaitable;
     }
+#endif
 
+    // Pre-C++20, `CompletionToken` and `Latch` are excluded explicitly: partial ordering cannot
+    // prefer their overloads, as `Data` appears only in non-deduced contexts.
     template <typename Data, typename F>
     SDK_CPP20_REQUIRES(
-        Data::writable && sizeof(F) <= 8 && alignof(F) <= 8
-        && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>
-        && requires(bool success, const F& f) { f(success); })
-    void write_async(
-        const F& f, typename Data::ValueType value,
-        std::chrono::steady_clock::duration timeout = default_timeout) {
+        Data::writable
+        && (requires(bool success, std::decay_t<F>& f) { f(success); }
+            || requires(bool success, uint32_t error_code, std::decay_t<F>& f) {
+                   f(success, error_code);
+               }))
+    auto write_async(
+        F&& f, typename Data::ValueType value,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) -> callback_overload<F> {
         static_assert(Data::writable, "");
 
-        static_assert(sizeof(F) <= 8, "");
-        static_assert(alignof(F) <= 8, "");
-        static_assert(std::is_trivially_copyable<F>::value, "");
-        static_assert(std::is_trivially_destructible<F>::value, "");
-
         Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            Buffer8 callback_context{f};
-            handler.write_async(
-                Buffer8{value}, storage_id, timeout.count(),
-                [](Buffer8 context, bool success) { context.as<F>()(success); }, callback_context);
+        std::integral_constant<bool, storage_count<Data>() == 1> single;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            submit_with_callback(
+                handler, pass_callback<F>(f, single),
+                [&](CallbackFunction callback, Buffer8 context) {
+                    handler.write_async(
+                        to_raw<Data>(value, policy), storage_id, timeout.count(), callback,
+                        context, confirmation);
+                });
         });
     }
 
+    // Adds writes of `Data` to `transaction` and returns the index of the first one.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    size_t stage_write(
+        Transaction& transaction, typename Data::ValueType value,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+
+        size_t first = transaction.items_.size();
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            transaction.items_.push_back(Transaction::Item{
+                storage_id, true, confirmation, to_raw<Data>(value, policy), false, 0});
+            transaction.policies_.push_back(policy);
+        });
+        return first;
+    }
+
+    // Adds reads of `Data` to `transaction` and returns the index of the first one.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::readable)
+    size_t stage_read(Transaction& transaction) {
+        static_assert(Data::readable, "");
+
+        size_t first = transaction.items_.size();
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            transaction.items_.push_back(Transaction::Item{
+                storage_id, false, WriteConfirmation::DEFAULT, Buffer8{}, false, 0});
+            transaction.policies_.push_back(policy);
+        });
+        return first;
+    }
+
+    // Sends all items of `transaction` at once. Throws like `Latch::wait` if any item failed;
+    // the result of each item is kept in `transaction`.
+    void execute(
+        Transaction& transaction, std::chrono::steady_clock::duration timeout = default_timeout) {
+        Latch latch;
+        execute_async(latch, transaction, timeout);
+        latch.wait();
+    }
+
+    void execute_async(
+        Latch& latch, Transaction& transaction,
+        std::chrono::steady_clock::duration timeout = default_timeout) {
+        Handler& handler = static_cast<T*>(this)->handler_;
+        latch.count_up();
+        handler.transact_async(
+            transaction.items_.data(), transaction.items_.size(), timeout.count(),
+            count_down_latch, Buffer8{&latch});
+    }
+
+    // Executes raw operations on arbitrary objects. Items are pipelined over a pool of storage
+    // units, so a batch may hold any number of them. Throws like `Latch::wait` if any failed;
+    // the result of each item is kept in `items`.
+    void execute_raw(
+        RawItem* items, size_t count,
+        std::chrono::steady_clock::duration timeout = default_timeout) {
+        Latch latch;
+        execute_raw_async(latch, items, count, timeout);
+        latch.wait();
+    }
+
+    void execute_raw_async(
+        Latch& latch, RawItem* items, size_t count,
+        std::chrono::steady_clock::duration timeout = default_timeout) {
+        Handler& handler = static_cast<T*>(this)->handler_;
+        latch.count_up();
+        handler.raw_transact_async(
+            items, count, timeout.count(), count_down_latch, Buffer8{&latch});
+    }
+
+    void execute_raw_async(
+        CompletionToken token, RawItem* items, size_t count,
+        std::chrono::steady_clock::duration timeout = default_timeout) {
+        Handler& handler = static_cast<T*>(this)->handler_;
+        handler.raw_transact_async(
+            items, count, timeout.count(), Handler::queue_completion, Buffer8{token.value});
+    }
+
     template <typename Data>
     SDK_CPP20_REQUIRES(Data::writable)
     void write_async_unchecked(
         typename Data::ValueType value,
-        std::chrono::steady_clock::duration timeout = default_timeout) {
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
         static_assert(Data::writable, "");
 
-        Handler& handler = static_cast<T*>(this)->handler_;
-        iterate<Data>([&](int storage_id) {
-            handler.write_async_unchecked(Buffer8{value}, storage_id, timeout.count());
+        int storage_ids[storage_count<Data>()];
+        Buffer8 raw_values[storage_count<Data>()];
+        int count = 0;
+        iterate_with_policy<Data>([&](int storage_id, uint32_t policy) {
+            storage_ids[count] = storage_id;
+            raw_values[count++] = to_raw<Data>(value, policy);
         });
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        if (storage_count<Data>() == 1)
+            handler.write_async_unchecked(
+                raw_values[0], storage_ids[0], timeout.count(), confirmation);
+        else
+            handler.write_async_unchecked_bulk(
+                raw_values, storage_ids, storage_count<Data>(), timeout.count(), confirmation);
+    }
+
+    // Sets the policy used by writes with `WriteConfirmation::DEFAULT`. Confirmed writes read
+    // the value back until it matches; unconfirmed writes complete on the write acknowledgement,
+    // which halves the traffic when streaming setpoints.
+    template <typename Data>
+    SDK_CPP20_REQUIRES(Data::writable)
+    void set_write_confirmation(bool confirmed) {
+        static_assert(Data::writable, "");
+
+        int storage_ids[storage_count<Data>()];
+        collect_storage_ids<Data>(storage_ids);
+
+        Handler& handler = static_cast<T*>(this)->handler_;
+        handler.set_write_confirmation(storage_ids, storage_count<Data>(), confirmed);
     }
 
 private:
+    template <typename Data>
+    static constexpr bool all_readable() {
+        return Data::readable;
+    }
+
+    template <typename Data, typename Next, typename... Datas>
+    static constexpr bool all_readable() {
+        return Data::readable && all_readable<Next, Datas...>();
+    }
+
     template <typename U>
     constexpr static decltype(std::declval<typename U::Sub>(), int()) data_count_internal(int) {
         return T::Datas::count + T::sub_count_ * T::Sub::data_count();
@@ -260,6 +1022,95 @@ private:
 protected:
     static constexpr int data_count() { return data_count_internal<T>(0); }
 
+    // Offset of the `k`th storage unit of `Data` from `storage_offset_`, following the layout of
+    // `sub`: the operator's own data, then `Sub::data_count()` units per sub-operator.
+    template <typename Data>
+    static constexpr typename std::enable_if<std::is_same<typename Data::Base, T>::value, int>::type
+        storage_id_offset(int) {
+        return T::Datas::template index<Data>();
+    }
+
+    template <typename Data>
+    static constexpr
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, int>::type
+        storage_id_offset(int k) {
+        return T::Datas::count
+             + k / T::Sub::template storage_count<Data>() * T::Sub::data_count()
+             + T::Sub::template storage_id_offset<Data>(
+                 k % T::Sub::template storage_count<Data>());
+    }
+
+    // Path (see `path_`) of the operator owning the `k`th storage unit of `Data`.
+    template <typename Data>
+    static constexpr
+        typename std::enable_if<std::is_same<typename Data::Base, T>::value, uint32_t>::type
+        unit_path(uint32_t path, int) {
+        return path;
+    }
+
+    template <typename Data>
+    static constexpr
+        typename std::enable_if<!std::is_same<typename Data::Base, T>::value, uint32_t>::type
+        unit_path(uint32_t path, int k) {
+        return T::Sub::template unit_path<Data>(
+            path << 8 | uint32_t(k / T::Sub::template storage_count<Data>()),
+            k % T::Sub::template storage_count<Data>());
+    }
+
+    template <typename Data, int... k>
+    static constexpr std::array<int, sizeof...(k)>
+        storage_id_offsets(std::integer_sequence<int, k...>) {
+        return {{storage_id_offset<Data>(k)...}};
+    }
+
+    // Copy between a selection array and its values in `iterate` order.
+    template <typename V, size_t N>
+    static const V* unflatten(V (&values)[N], const V* flat) {
+        for (auto& value : values)
+            value = *flat++;
+        return flat;
+    }
+
+    template <typename V, size_t N, size_t M>
+    static const V* unflatten(V (&values)[N][M], const V* flat) {
+        for (auto& row : values)
+            flat = unflatten(row, flat);
+        return flat;
+    }
+
+    template <typename V, size_t N>
+    static V* flatten(const V (&values)[N], V* flat) {
+        for (const auto& value : values)
+            *flat++ = value;
+        return flat;
+    }
+
+    template <typename V, size_t N, size_t M>
+    static V* flatten(const V (&values)[N][M], V* flat) {
+        for (const auto& row : values)
+            flat = flatten(row, flat);
+        return flat;
+    }
+
+    template <typename... Datas>
+    static constexpr int storage_count_of() {
+        return storage_count_sum<Datas...>();
+    }
+
+    template <typename... Datas>
+    int* storage_ids_of(int* storage_ids) {
+        return collect_storage_ids<Datas...>(storage_ids);
+    }
+
+    // Stages an item on a storage unit directly, regardless of the access of its data type.
+    // `data` is a raw value.
+    static void
+        stage_storage(Transaction& transaction, int storage_id, bool write, Buffer8 data = {}) {
+        transaction.items_.push_back(
+            Transaction::Item{storage_id, write, WriteConfirmation::DEFAULT, data, false, 0});
+        transaction.policies_.push_back(StorageInfo::NONE);
+    }
+
     void init_storage_info(uint32_t mask, uint32_t i = 0, uint32_t shape = 0) {
         T& self = *static_cast<T*>(this);
         auto initializer = StorageInitializer(self, mask, i, shape);
@@ -25,23 +25,26 @@ public:
     }
 
 private:
-    Finger(protocol::Handler& handler, uint16_t index_offset, int storage_offset)
+    Finger(protocol::Handler& handler, uint16_t index_offset, int storage_offset, uint32_t path)
         : handler_(handler)
         , index_offset_(index_offset)
-        , storage_offset_(storage_offset) {}
+        , storage_offset_(storage_offset)
+        , path_(path) {}
 
     using Datas = DataTuple<>;
 
     protocol::Handler& handler_;
     uint16_t index_offset_;
     int storage_offset_;
+    uint32_t path_;
 
     using Sub = Joint;
     static constexpr int sub_count_ = 4;
     Sub sub(int index) {
         return {
             handler_, uint16_t(index_offset_ + index * 0x100),
-            int(storage_offset_ + Datas::count + index * Sub::data_count())};
+            int(storage_offset_ + Datas::count + index * Sub::data_count()),
+            path_ << 8 | uint32_t(index)};
     }
 };
 
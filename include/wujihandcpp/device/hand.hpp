@@ -2,8 +2,12 @@
 
 #include <cstdint>
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "wujihandcpp/data/hand.hpp"
 #include "wujihandcpp/data/joint.hpp"
@@ -11,6 +15,8 @@
 #include "wujihandcpp/device/data_operator.hpp"
 #include "wujihandcpp/device/data_tuple.hpp"
 #include "wujihandcpp/device/finger.hpp"
+#include "wujihandcpp/device/snapshot.hpp"
+#include "wujihandcpp/device/transaction.hpp"
 #include "wujihandcpp/protocol/handler.hpp"
 
 namespace wujihandcpp {
@@ -88,30 +94,99 @@ class Hand : public DataOperator<Hand> {
         FilteredController<FilterT, true>* controller_;
     };
 
+    // Data types kept in a snapshot, in this order. The fingerprint identifies the firmware and
+    // joint hardware and is verified on restore; static information is then trusted if the
+    // snapshot was also taken from the hand with the same serial number, and configuration is
+    // written again.
+    int* snapshot_storage_ids(int* storage_ids) {
+        return storage_ids_of<
+            data::hand::FirmwareVersion, data::hand::FirmwareDate, data::joint::HardwareVersion,
+            data::joint::HardwareDate, data::hand::Handedness, data::joint::UpperLimit,
+            data::joint::LowerLimit, data::joint::CurrentLimit>(storage_ids);
+    }
+
+    static constexpr int snapshot_fingerprint_count() {
+        return storage_count_of<
+            data::hand::FirmwareVersion, data::hand::FirmwareDate, data::joint::HardwareVersion,
+            data::joint::HardwareDate>();
+    }
+
+    static constexpr int snapshot_static_count() {
+        return storage_count_of<
+            data::hand::Handedness, data::joint::UpperLimit, data::joint::LowerLimit>();
+    }
+
+    static constexpr int snapshot_configuration_count() {
+        return storage_count_of<data::joint::CurrentLimit>();
+    }
+
+    static constexpr int snapshot_count() {
+        return snapshot_fingerprint_count() + snapshot_static_count()
+             + snapshot_configuration_count();
+    }
+
 public:
+    // How long each phase of opening the hand took.
+    struct OpenTimings {
+        // Finding and claiming the USB device.
+        std::chrono::steady_clock::duration usb;
+        // Checking the firmware (and the snapshot, if any) while disabling the joints.
+        std::chrono::steady_clock::duration identification;
+        // Reading missing static information and writing the joint configuration.
+        std::chrono::steady_clock::duration configuration;
+        std::chrono::steady_clock::duration total;
+    };
+
+    // Only bounds the wait for the frame to leave the host, see `emergency_stop`.
+    static constexpr std::chrono::steady_clock::duration emergency_stop_timeout =
+        std::chrono::milliseconds(100);
+
     explicit Hand(
         const char* serial_number = nullptr, int32_t usb_pid = -1, uint16_t usb_vid = 0x0483,
         uint32_t mask = 0)
-        : handler_(usb_vid, usb_pid, serial_number, 64, data_count()) {
+        : Hand(std::chrono::steady_clock::now(), nullptr, serial_number, usb_pid, usb_vid, mask) {}
 
-        init_storage_info(mask);
+    // Warm start from a snapshot taken with `save_snapshot`: one round trip verifies it while
+    // disabling the joints, and static information (including the joint limits) is restored
+    // from it instead of being read again. The configuration is then written in a second round
+    // trip. Static information is read again if the snapshot comes from a hand with another
+    // serial number or firmware.
+    explicit Hand(
+        const Snapshot& snapshot, const char* serial_number = nullptr, int32_t usb_pid = -1,
+        uint16_t usb_vid = 0x0483, uint32_t mask = 0)
+        : Hand(
+              std::chrono::steady_clock::now(), &snapshot, serial_number, usb_pid, usb_vid, mask) {}
+
+    // Opens a hand on a thread of its own; the future rethrows what the constructor threw.
+    // Opening several hands this way overlaps their startup. Give each one a serial number, so
+    // that they do not race for the same device.
+    static std::future<std::unique_ptr<Hand>> open_async(
+        const char* serial_number = nullptr, int32_t usb_pid = -1, uint16_t usb_vid = 0x0483,
+        uint32_t mask = 0) {
+        bool has_serial_number = serial_number != nullptr;
+        std::string serial(has_serial_number ? serial_number : "");
+        return std::async(
+            std::launch::async, [has_serial_number, serial, usb_pid, usb_vid, mask]() {
+                return std::make_unique<Hand>(
+                    has_serial_number ? serial.c_str() : nullptr, usb_pid, usb_vid, mask);
+            });
+    }
 
-        try {
-            auto version = data::FirmwareVersionData{read<data::hand::FirmwareVersion>()};
-            if (version < data::FirmwareVersionData{3, 0, 0})
-                throw std::runtime_error(
-                    "The firmware version (" + version.to_string()
-                    + ") is outdated. Please contact after-sales service for an upgrade.");
-
-            write<data::joint::Enabled>(false);
-            Latch latch;
-            write_async<data::joint::ControlMode>(latch, 6);
-            write_async<data::joint::CurrentLimit>(latch, 1000);
-            latch.wait();
-        } catch (const TimeoutError&) {
-            throw TimeoutError("Hand initialization timed out: joint configuration incomplete");
-        }
-    };
+    static std::future<std::unique_ptr<Hand>> open_async(
+        Snapshot snapshot, const char* serial_number = nullptr, int32_t usb_pid = -1,
+        uint16_t usb_vid = 0x0483, uint32_t mask = 0) {
+        bool has_serial_number = serial_number != nullptr;
+        std::string serial(has_serial_number ? serial_number : "");
+        return std::async(
+            std::launch::async,
+            [has_serial_number, serial, usb_pid, usb_vid, mask](const Snapshot& snapshot) {
+                return std::make_unique<Hand>(
+                    snapshot, has_serial_number ? serial.c_str() : nullptr, usb_pid, usb_vid, mask);
+            },
+            std::move(snapshot));
+    }
+
+    const OpenTimings& open_timings() const { return open_timings_; }
 
     Finger finger_thumb() { return finger(0); }
     Finger finger_index() { return finger(1); }
@@ -160,15 +235,12 @@ public:
         save_and_disable_joints(last_enabled);
 
         {
-            Latch latch;
-            write_async<data::joint::ControlMode>(latch, 5);
-            if (enable_upstream)
-                write_async<data::hand::TPdoId>(latch, 1);
-            else
-                write_async<data::hand::TPdoId>(latch, 0);
-            write_async<data::hand::PdoInterval>(latch, 2000);
-            write_async<data::hand::PdoEnabled>(latch, 1);
-            latch.wait();
+            Transaction transaction;
+            stage_write<data::joint::ControlMode>(transaction, 5);
+            stage_write<data::hand::TPdoId>(transaction, enable_upstream ? 1 : 0);
+            stage_write<data::hand::PdoInterval>(transaction, 2000);
+            stage_write<data::hand::PdoEnabled>(transaction, 1);
+            execute(transaction);
         }
 
         revert_disabled_joints(last_enabled);
@@ -181,10 +253,10 @@ public:
         save_and_disable_joints(last_enabled);
 
         {
-            Latch latch;
-            write_async<data::joint::ControlMode>(latch, 6);
-            write_async<data::hand::PdoEnabled>(latch, 0);
-            latch.wait();
+            Transaction transaction;
+            stage_write<data::joint::ControlMode>(transaction, 6);
+            stage_write<data::hand::PdoEnabled>(transaction, 0);
+            execute(transaction);
         }
 
         revert_disabled_joints(last_enabled);
@@ -192,9 +264,192 @@ public:
         return std::unique_ptr<IRealtimeController>{handler_.detach_realtime_controller()};
     }
 
-    void disable_thread_safe_check() { handler_.disable_thread_safe_check(); }
+    // Captures the static information and the applied configuration of the hand. Static
+    // information that was never read is read first.
+    Snapshot save_snapshot(std::chrono::steady_clock::duration timeout = default_timeout) {
+        int storage_ids[snapshot_count()];
+        snapshot_storage_ids(storage_ids);
+
+        uint32_t versions[snapshot_count()];
+        handler_.get_versions(storage_ids, snapshot_count(), versions);
+        Transaction transaction;
+        for (int i = 0; i < snapshot_fingerprint_count() + snapshot_static_count(); i++)
+            if (!versions[i])
+                stage_storage(transaction, storage_ids[i], false);
+        if (!transaction.empty())
+            execute(transaction, timeout);
+
+        Snapshot snapshot;
+        snapshot.serial_number_ = handler_.serial_number();
+        snapshot.records_.reserve(snapshot_count());
+        for (int storage_id : storage_ids)
+            snapshot.records_.push_back(
+                Snapshot::Record{uint16_t(storage_id), handler_.get(storage_id)});
+        return snapshot;
+    }
+
+    protocol::Handler::SdoStatistics sdo_statistics() { return handler_.sdo_statistics(); }
+
+    protocol::Handler::RttStatistics rtt_statistics() { return handler_.rtt_statistics(); }
+
+    protocol::Handler::TrafficStatistics traffic_statistics() {
+        return handler_.traffic_statistics();
+    }
+
+    // Interval of the empty frames sent while no SDO request is pending (0: none).
+    void set_heartbeat_interval(std::chrono::steady_clock::duration interval) {
+        handler_.set_heartbeat_interval(interval.count());
+    }
+
+    // Limits SDO requests while a realtime controller streams PDO frames (0: no limit).
+    void set_sdo_bandwidth_limit(uint32_t bytes_per_second) {
+        handler_.set_sdo_bandwidth_limit(bytes_per_second);
+    }
+
+    // Collects completions of operations submitted with a `CompletionToken`, waiting up to
+    // `timeout` for the first one (negative: no limit). Call from one thread at a time.
+    size_t poll_completions(
+        Completion* completions, size_t max_count,
+        std::chrono::steady_clock::duration timeout = std::chrono::steady_clock::duration::zero()) {
+        return handler_.poll_completions(completions, max_count, timeout.count());
+    }
+
+    // Disables all joints with one frame that is sent from the calling thread at once, without
+    // waiting for the tick thread or for queued operations. Returns the time until the frame left
+    // the host. The disables are also queued as unchecked writes, which are retried until the
+    // device confirms them, and pending writes of `Enabled` are dropped. The wait never
+    // exceeds one second, whatever `timeout` is.
+    std::chrono::steady_clock::duration
+        emergency_stop(std::chrono::steady_clock::duration timeout = emergency_stop_timeout) {
+        return select<data::joint::Enabled>().write_immediately(false, timeout);
+    }
+
+    // Kept for compatibility and does nothing: operations may be issued from any thread.
+    [[deprecated("Operations may be issued from any thread; this call does nothing.")]]
+    void disable_thread_safe_check() {}
 
 private:
+    explicit Hand(
+        std::chrono::steady_clock::time_point open_begin, const Snapshot* snapshot,
+        const char* serial_number, int32_t usb_pid, uint16_t usb_vid, uint32_t mask)
+        : handler_(usb_vid, usb_pid, serial_number, 64, data_count()) {
+        open_timings_.usb = std::chrono::steady_clock::now() - open_begin;
+
+        init_storage_info(mask);
+        initialize(snapshot);
+        open_timings_.total = std::chrono::steady_clock::now() - open_begin;
+    }
+
+    void initialize(const Snapshot* snapshot) {
+        try {
+            if (!snapshot || !warm_start(*snapshot))
+                cold_start();
+        } catch (const TimeoutError&) {
+            throw TimeoutError("Hand initialization timed out: joint configuration incomplete");
+        }
+    }
+
+    static void check_firmware_version(data::FirmwareVersionData version) {
+        if (version < data::FirmwareVersionData{3, 0, 0})
+            throw std::runtime_error(
+                "The firmware version (" + version.to_string()
+                + ") is outdated. Please contact after-sales service for an upgrade.");
+    }
+
+    // Executes `transaction`, whose item `version_item` reads the firmware version, and checks
+    // the version before reporting failures of the other items: outdated firmware may reject
+    // them, and is then reported as outdated.
+    void execute_identification(Transaction& transaction, size_t version_item) {
+        try {
+            execute(transaction);
+        } catch (const std::runtime_error&) {
+            if (transaction[version_item].success)
+                check_firmware_version(data::FirmwareVersionData{
+                    transaction.value<data::hand::FirmwareVersion>(version_item)});
+            throw;
+        }
+        check_firmware_version(data::FirmwareVersionData{
+            transaction.value<data::hand::FirmwareVersion>(version_item)});
+    }
+
+    void cold_start() {
+        // The joints are disabled in the frames of the version read instead of waiting for the
+        // check.
+        auto phase_begin = std::chrono::steady_clock::now();
+        Transaction identification;
+        size_t version_item = stage_read<data::hand::FirmwareVersion>(identification);
+        stage_write<data::joint::Enabled>(identification, false);
+        execute_identification(identification, version_item);
+        open_timings_.identification = std::chrono::steady_clock::now() - phase_begin;
+
+        phase_begin = std::chrono::steady_clock::now();
+        Transaction transaction;
+        stage_write<data::joint::ControlMode>(transaction, 6);
+        stage_write<data::joint::CurrentLimit>(transaction, 1000);
+        execute(transaction);
+        open_timings_.configuration = std::chrono::steady_clock::now() - phase_begin;
+    }
+
+    // Returns false, without touching the hand, if the snapshot has another layout.
+    bool warm_start(const Snapshot& snapshot) {
+        int storage_ids[snapshot_count()];
+        snapshot_storage_ids(storage_ids);
+        if (snapshot.size() != size_t(snapshot_count()))
+            return false;
+        for (int i = 0; i < snapshot_count(); i++)
+            if (snapshot[i].storage_id != storage_ids[i])
+                return false;
+
+        const int* fingerprint_ids = storage_ids;
+        const int* static_ids = fingerprint_ids + snapshot_fingerprint_count();
+        const int* configuration_ids = static_ids + snapshot_static_count();
+
+        // The fingerprint is read back while the joints are disabled in the same frames.
+        auto phase_begin = std::chrono::steady_clock::now();
+        Transaction verification;
+        for (int i = 0; i < snapshot_fingerprint_count(); i++)
+            stage_storage(verification, fingerprint_ids[i], false);
+        stage_write<data::joint::Enabled>(verification, false);
+        execute_identification(verification, 0);
+        open_timings_.identification = std::chrono::steady_clock::now() - phase_begin;
+        phase_begin = std::chrono::steady_clock::now();
+
+        // Hands of one batch share the fingerprint, but not their calibration. All fingerprint
+        // objects hold 32-bit values.
+        bool matches = !snapshot.serial_number().empty()
+                    && snapshot.serial_number() == handler_.serial_number();
+        for (int i = 0; i < snapshot_fingerprint_count(); i++)
+            if (verification[i].data.as<uint32_t>() != snapshot[i].value.as<uint32_t>())
+                matches = false;
+
+        // The configuration objects are write-only, so they are written whether or not they
+        // differ, once the joints are disabled. Same configuration as `cold_start`, unless the
+        // snapshot recorded another one.
+        using Buffer8 = protocol::Handler::Buffer8;
+        const uint16_t default_current_limit = 1000;
+        Transaction configuration;
+        stage_write<data::joint::ControlMode>(configuration, 6);
+        for (int i = 0; i < snapshot_configuration_count(); i++) {
+            uint16_t current_limit =
+                matches ? snapshot[snapshot_count() - snapshot_configuration_count() + i]
+                              .value.as<uint16_t>()
+                        : default_current_limit;
+            stage_storage(configuration, configuration_ids[i], true, Buffer8{current_limit});
+        }
+        if (matches) {
+            for (int i = 0; i < snapshot_static_count(); i++)
+                handler_.restore_value(
+                    static_ids[i], snapshot[snapshot_fingerprint_count() + i].value);
+        } else {
+            for (int i = 0; i < snapshot_static_count(); i++)
+                stage_storage(configuration, static_ids[i], false);
+        }
+        execute(configuration);
+        open_timings_.configuration = std::chrono::steady_clock::now() - phase_begin;
+
+        return true;
+    }
+
     void save_and_enable_joints(bool (&last_enabled)[5][4]) {
         Latch latch;
         for (int i = 0; i < 5; i++)
@@ -244,16 +499,18 @@ private:
         data::hand::RPdoTriggerOffset, data::hand::TPdoTriggerOffset>;
 
     protocol::Handler handler_;
+    OpenTimings open_timings_{};
 
     static constexpr uint16_t index_offset_ = 0x0000;
     static constexpr int storage_offset_ = 0;
+    static constexpr uint32_t path_ = 0;
 
     using Sub = Finger;
     static constexpr int sub_count_ = 5;
     Sub sub(int index) {
         return {
             handler_, uint16_t(0x2000 + index * 0x800),
-            int(Datas::count + index * Sub::data_count())};
+            int(Datas::count + index * Sub::data_count()), uint32_t(index)};
     }
 };
 
@@ -15,10 +15,11 @@ class Joint : public DataOperator<Joint> {
     friend class Finger;
 
 private:
-    Joint(protocol::Handler& handler, uint16_t index_offset, int storage_offset)
+    Joint(protocol::Handler& handler, uint16_t index_offset, int storage_offset, uint32_t path)
         : handler_(handler)
         , index_offset_(index_offset)
-        , storage_offset_(storage_offset) {}
+        , storage_offset_(storage_offset)
+        , path_(path) {}
 
     using Datas = DataTuple<
         data::joint::HardwareVersion, data::joint::HardwareDate, data::joint::ControlMode,
@@ -30,6 +31,7 @@ private:
     protocol::Handler& handler_;
     uint16_t index_offset_;
     int storage_offset_;
+    uint32_t path_;
 };
 
 } // namespace device
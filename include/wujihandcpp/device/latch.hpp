@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+
 #include <atomic>
+#include <chrono>
 #include <stdexcept>
 #include <string>
 
@@ -14,32 +17,94 @@ public:
     using runtime_error::runtime_error;
 };
 
+// Thrown when the device rejects an operation with an SDO error response.
+class SdoError : public std::runtime_error {
+public:
+    explicit SdoError(const std::string& what, uint32_t error_code)
+        : runtime_error(what)
+        , error_code_(error_code) {}
+
+    // The device `err_code` of the first rejected operation.
+    uint32_t error_code() const noexcept { return error_code_; }
+
+private:
+    uint32_t error_code_;
+};
+
 class Latch {
 public:
     template <typename T>
     friend class DataOperator;
+    template <typename Data, int count>
+    friend class OperationAwaitable;
+    template <typename Data>
+    friend class Selection;
 
     WUJIHANDCPP_API void wait() {
-        if (int error_count = try_wait_internal()) {
-            if (error_count == 1)
-                throw TimeoutError("Operation timed out while waiting for completion");
-            else
-                throw TimeoutError(
-                    std::to_string(error_count)
-                    + " operations timed out while waiting for completion");
-        }
+        uint32_t error_code;
+        int error_count = try_wait_internal(error_code);
+        throw_if_failed(error_count, error_code);
+    }
+
+    // Like `wait`, but gives up at `deadline` and returns false if operations are still pending.
+    // They keep referring to the latch, so wait again before destroying it.
+    WUJIHANDCPP_API bool wait_until(std::chrono::steady_clock::time_point deadline) {
+        uint32_t error_code;
+        int error_count = try_wait_internal(deadline, error_code);
+        if (error_count < 0)
+            return false;
+        throw_if_failed(error_count, error_code);
+        return true;
     }
 
-    WUJIHANDCPP_API bool try_wait() noexcept { return try_wait_internal() == 0; }
+    WUJIHANDCPP_API bool wait_for(std::chrono::steady_clock::duration timeout) {
+        auto now = std::chrono::steady_clock::now();
+        if (timeout >= std::chrono::steady_clock::time_point::max() - now)
+            return wait_until(std::chrono::steady_clock::time_point::max());
+        return wait_until(now + timeout);
+    }
+
+    WUJIHANDCPP_API bool try_wait() noexcept {
+        uint32_t error_code;
+        return try_wait_internal(error_code) == 0;
+    }
+
+    // Waits spin for up to `limit` before blocking, as long as recent waits took less than
+    // `limit`. Zero always blocks right away. Applies to all latches.
+    WUJIHANDCPP_API static void set_spin_limit(std::chrono::steady_clock::duration limit) noexcept;
 
 private:
-    WUJIHANDCPP_API int try_wait_internal() noexcept;
+    void throw_if_failed(int error_count, uint32_t error_code) {
+        if (!error_count)
+            return;
+        if (error_code)
+            throw_sdo_error(error_count, error_code);
+        else if (error_count == 1)
+            throw TimeoutError("Operation timed out while waiting for completion");
+        else
+            throw TimeoutError(
+                std::to_string(error_count) + " operations timed out while waiting for completion");
+    }
+
+    WUJIHANDCPP_API int try_wait_internal(uint32_t& error_code) noexcept;
+
+    // Returns -1 if operations are still pending at `deadline`.
+    WUJIHANDCPP_API int try_wait_internal(
+        std::chrono::steady_clock::time_point deadline, uint32_t& error_code) noexcept;
+
+    // How long the next wait spins before blocking.
+    WUJIHANDCPP_API static std::chrono::steady_clock::duration spin_budget() noexcept;
+
+    [[noreturn]] WUJIHANDCPP_API static void throw_sdo_error(int error_count, uint32_t error_code);
 
     WUJIHANDCPP_API void count_up() noexcept;
-    WUJIHANDCPP_API void count_down(bool success) noexcept;
+    WUJIHANDCPP_API void count_down(bool success, uint32_t error_code = 0) noexcept;
 
-    std::atomic<int> waiting_count_{0};
+    // Pending operations, plus `sleeping_flag` while the waiter blocks.
+    static constexpr uint32_t sleeping_flag = uint32_t(1) << 31;
+    std::atomic<uint32_t> waiting_count_{0};
     std::atomic<int> error_count_{0};
+    std::atomic<uint32_t> error_code_{0};
 };
 
 } // namespace device
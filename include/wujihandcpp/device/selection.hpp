@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+
+#include "wujihandcpp/data/helper.hpp"
+#include "wujihandcpp/device/completion.hpp"
+#include "wujihandcpp/device/latch.hpp"
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+template <typename T>
+class DataOperator;
+
+// A prepared subset of the storage units of `Data`, built once with `select`. It keeps the
+// storage ids and conversion policies in flat arrays, so repeated operations skip the walk
+// through `finger(i).joint(j)` and its bounds checks. Values are passed in selection order.
+//
+// Refers to the hand it was selected from, which must outlive it.
+template <typename Data>
+class Selection {
+public:
+    using ValueType = typename Data::ValueType;
+    using WriteConfirmation = protocol::Handler::WriteConfirmation;
+
+    // Bits of the `select` mask.
+    static constexpr size_t max_size = 32;
+
+    // Same as `DataOperator::default_timeout`.
+    static constexpr std::chrono::steady_clock::duration default_timeout =
+        std::chrono::milliseconds(500);
+
+    size_t size() const { return count_; }
+
+    int storage_id(size_t index) const { return storage_ids_[index]; }
+
+    ValueType get(size_t index) const {
+        return from_raw(handler_->get(storage_ids_[index]), policies_[index]);
+    }
+
+    void get_all(ValueType* values) const {
+        for (size_t i = 0; i < count_; i++)
+            values[i] = from_raw(handler_->get(storage_ids_[i]), policies_[i]);
+    }
+
+    void read(std::chrono::steady_clock::duration timeout = default_timeout) {
+        Latch latch;
+        read_async(latch, timeout);
+        latch.wait();
+    }
+
+    void read(ValueType* values, std::chrono::steady_clock::duration timeout = default_timeout) {
+        read(timeout);
+        get_all(values);
+    }
+
+    void read_async(Latch& latch, std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(Data::readable, "");
+        if (!count_)
+            return;
+        latch.count_up();
+        handler_->read_async_bulk(
+            storage_ids_, count_, timeout.count(), count_down_latch, Buffer8{&latch});
+    }
+
+    // Reports completion to the completion queue, see `Hand::poll_completions`.
+    void read_async(
+        CompletionToken token, std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(Data::readable, "");
+        if (!count_)
+            return;
+        handler_->read_async_bulk(
+            storage_ids_, count_, timeout.count(), protocol::Handler::queue_completion,
+            Buffer8{token.value});
+    }
+
+    // Writes `value` to every storage unit of the selection.
+    void write(
+        ValueType value, std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        Latch latch;
+        write_async(latch, value, timeout, confirmation);
+        latch.wait();
+    }
+
+    // Writes `values[i]` to the `i`th storage unit of the selection.
+    void write(
+        const ValueType* values, std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        Latch latch;
+        write_async(latch, values, timeout, confirmation);
+        latch.wait();
+    }
+
+    void write_async(
+        Latch& latch, ValueType value,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        Buffer8 raw_values[max_size];
+        for (size_t i = 0; i < count_; i++)
+            raw_values[i] = to_raw(value, policies_[i]);
+        write_async_internal(latch, raw_values, timeout, confirmation);
+    }
+
+    void write_async(
+        Latch& latch, const ValueType* values,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        Buffer8 raw_values[max_size];
+        for (size_t i = 0; i < count_; i++)
+            raw_values[i] = to_raw(values[i], policies_[i]);
+        write_async_internal(latch, raw_values, timeout, confirmation);
+    }
+
+    void write_async(
+        CompletionToken token, const ValueType* values,
+        std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+        if (!count_)
+            return;
+        Buffer8 raw_values[max_size];
+        for (size_t i = 0; i < count_; i++)
+            raw_values[i] = to_raw(values[i], policies_[i]);
+        handler_->write_async_bulk(
+            raw_values, storage_ids_, count_, timeout.count(), protocol::Handler::queue_completion,
+            Buffer8{token.value}, confirmation);
+    }
+
+    // Streams `values`, superseding pending writes like `write_async_unchecked`.
+    void write_unchecked(
+        const ValueType* values, std::chrono::steady_clock::duration timeout = default_timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT) {
+        static_assert(Data::writable, "");
+        Buffer8 raw_values[max_size];
+        for (size_t i = 0; i < count_; i++)
+            raw_values[i] = to_raw(values[i], policies_[i]);
+        handler_->write_async_unchecked_bulk(
+            raw_values, storage_ids_, count_, timeout.count(), confirmation);
+    }
+
+    // Sends `value` to every storage unit in one frame, ahead of queued operations, see
+    // `Handler::write_immediately`. Returns the time until the frame left the host.
+    std::chrono::steady_clock::duration write_immediately(
+        ValueType value, std::chrono::steady_clock::duration timeout = default_timeout) {
+        static_assert(Data::writable, "");
+        static_assert(max_size <= protocol::Handler::max_immediate_write_count);
+        Buffer8 raw_values[max_size];
+        for (size_t i = 0; i < count_; i++)
+            raw_values[i] = to_raw(value, policies_[i]);
+        auto latency =
+            handler_->write_immediately(raw_values, storage_ids_, count_, timeout.count());
+        if (latency < 0)
+            throw TimeoutError("Operation timed out while waiting for transmission");
+        return std::chrono::steady_clock::duration{latency};
+    }
+
+private:
+    template <typename T>
+    friend class DataOperator;
+
+    using Buffer8 = protocol::Handler::Buffer8;
+
+    explicit Selection(protocol::Handler& handler)
+        : handler_(&handler) {}
+
+    void add(int storage_id, uint32_t policy) {
+        storage_ids_[count_] = storage_id;
+        policies_[count_] = policy;
+        count_++;
+    }
+
+    static Buffer8 to_raw(const ValueType& value, uint32_t policy) {
+        return data::ConversionOf<Data>::to_raw(value, policy);
+    }
+
+    static ValueType from_raw(Buffer8 raw, uint32_t policy) {
+        return data::ConversionOf<Data>::template from_raw<ValueType>(raw, policy);
+    }
+
+    static void count_down_latch(Buffer8 context, bool success, uint32_t error_code) {
+        context.as<Latch*>()->count_down(success, error_code);
+    }
+
+    void write_async_internal(
+        Latch& latch, const Buffer8* raw_values, std::chrono::steady_clock::duration timeout,
+        WriteConfirmation confirmation) {
+        static_assert(Data::writable, "");
+        if (!count_)
+            return;
+        latch.count_up();
+        handler_->write_async_bulk(
+            raw_values, storage_ids_, count_, timeout.count(), count_down_latch, Buffer8{&latch},
+            confirmation);
+    }
+
+    protocol::Handler* handler_;
+    size_t count_ = 0;
+    int storage_ids_[max_size];
+    uint32_t policies_[max_size];
+};
+
+} // namespace device
+} // namespace wujihandcpp
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+// Cached dictionary values of a hand: its static information and applied configuration. Take it
+// with `Hand::save_snapshot`, keep it in a file, and pass it to the `Hand` constructor for a warm
+// start.
+class Snapshot {
+public:
+    struct Record {
+        uint16_t storage_id;
+        protocol::Handler::Buffer8 value;
+    };
+
+    size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+
+    const Record& operator[](size_t index) const { return records_[index]; }
+
+    // USB serial number of the hand the snapshot was taken from. A warm start only trusts the
+    // per-hand calibration in the snapshot on the hand with this serial number.
+    const std::string& serial_number() const { return serial_number_; }
+
+    // Writes the snapshot to `path` in a compact binary format. Throws on I/O errors.
+    void save(const char* path) const {
+        File file{std::fopen(path, "wb")};
+        if (!file)
+            throw std::runtime_error(std::string("Failed to create snapshot file: ") + path);
+
+        uint8_t header[header_size];
+        std::memcpy(header, magic(), 4);
+        store_u16(header + 4, format_version);
+        store_u16(header + 6, static_cast<uint16_t>(records_.size()));
+        bool ok = std::fwrite(header, sizeof(header), 1, file.get()) == 1;
+
+        uint8_t serial_number_size[2];
+        store_u16(serial_number_size, static_cast<uint16_t>(serial_number_.size()));
+        ok = ok && std::fwrite(serial_number_size, sizeof(serial_number_size), 1, file.get()) == 1;
+        ok = ok
+          && std::fwrite(serial_number_.data(), 1, serial_number_.size(), file.get())
+                 == serial_number_.size();
+
+        for (const auto& record : records_) {
+            uint8_t buffer[record_size];
+            store_u16(buffer, record.storage_id);
+            std::memcpy(buffer + 2, record.value.storage, sizeof(record.value.storage));
+            ok = ok && std::fwrite(buffer, sizeof(buffer), 1, file.get()) == 1;
+        }
+
+        if (!ok || std::fflush(file.get()) != 0)
+            throw std::runtime_error(std::string("Failed to write snapshot file: ") + path);
+    }
+
+    // Reads a snapshot written by `save`. Throws if the file is missing or malformed.
+    static Snapshot load(const char* path) {
+        File file{std::fopen(path, "rb")};
+        if (!file)
+            throw std::runtime_error(std::string("Failed to open snapshot file: ") + path);
+
+        uint8_t header[header_size];
+        if (std::fread(header, sizeof(header), 1, file.get()) != 1
+            || std::memcmp(header, magic(), 4) != 0 || load_u16(header + 4) == 0
+            || load_u16(header + 4) > format_version)
+            throw std::runtime_error(std::string("Not a snapshot file: ") + path);
+
+        Snapshot snapshot;
+        // Version 1 has no serial number, so its calibration is never trusted.
+        if (load_u16(header + 4) >= 2) {
+            uint8_t serial_number_size[2];
+            if (std::fread(serial_number_size, sizeof(serial_number_size), 1, file.get()) != 1)
+                throw std::runtime_error(std::string("Truncated snapshot file: ") + path);
+            auto& serial_number = snapshot.serial_number_;
+            serial_number.resize(load_u16(serial_number_size));
+            if (std::fread(&serial_number[0], 1, serial_number.size(), file.get())
+                != serial_number.size())
+                throw std::runtime_error(std::string("Truncated snapshot file: ") + path);
+        }
+        snapshot.records_.resize(load_u16(header + 6));
+        for (auto& record : snapshot.records_) {
+            uint8_t buffer[record_size];
+            if (std::fread(buffer, sizeof(buffer), 1, file.get()) != 1)
+                throw std::runtime_error(std::string("Truncated snapshot file: ") + path);
+            record.storage_id = load_u16(buffer);
+            std::memcpy(record.value.storage, buffer + 2, sizeof(record.value.storage));
+        }
+        return snapshot;
+    }
+
+private:
+    friend class Hand;
+
+    struct FileCloser {
+        void operator()(std::FILE* file) const { std::fclose(file); }
+    };
+    using File = std::unique_ptr<std::FILE, FileCloser>;
+
+    static const char* magic() { return "WJHS"; }
+    static constexpr uint16_t format_version = 2;
+    static constexpr size_t header_size = 8;
+    static constexpr size_t record_size = 10;
+
+    static void store_u16(uint8_t* destination, uint16_t value) {
+        destination[0] = static_cast<uint8_t>(value);
+        destination[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    static uint16_t load_u16(const uint8_t* source) {
+        return static_cast<uint16_t>(source[0] | source[1] << 8);
+    }
+
+    std::string serial_number_;
+    std::vector<Record> records_;
+};
+
+} // namespace device
+} // namespace wujihandcpp
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "wujihandcpp/data/helper.hpp"
+#include "wujihandcpp/protocol/handler.hpp"
+
+namespace wujihandcpp {
+namespace device {
+
+// Collects reads and writes of any data types, which `execute` sends together in the same
+// frames and completes once. Each item keeps its own result.
+//
+// Must not be modified or destroyed while an `execute_async` on it is pending.
+class Transaction {
+public:
+    using Item = protocol::Handler::TransactionItem;
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+
+    const Item& operator[](size_t index) const { return items_[index]; }
+
+    // The value read by the item at `index`, valid once the transaction succeeded.
+    template <typename Data>
+    typename Data::ValueType value(size_t index) const {
+        return data::ConversionOf<Data>::template from_raw<typename Data::ValueType>(
+            items_[index].data, policies_[index]);
+    }
+
+    bool all_succeeded() const {
+        for (const auto& item : items_)
+            if (!item.success)
+                return false;
+        return true;
+    }
+
+    void clear() {
+        items_.clear();
+        policies_.clear();
+    }
+
+private:
+    template <typename T>
+    friend class DataOperator;
+
+    std::vector<Item> items_;
+    // Completes the conversion of each item, see `data::Conversion`.
+    std::vector<uint32_t> policies_;
+};
+
+// Raw access to arbitrary objects of the device dictionary, by index and sub-index, bypassing
+// the data types. Values are raw device values. Execute a batch with `execute_raw`.
+using RawItem = protocol::Handler::RawItem;
+
+inline RawItem raw_read(uint16_t index, uint8_t sub_index, size_t size) {
+    if (size != 1 && size != 2 && size != 4 && size != 8)
+        throw std::invalid_argument("Object size must be 1, 2, 4 or 8 bytes.");
+    return RawItem{
+        index,
+        sub_index,
+        protocol::Handler::StorageInfo{size, index, sub_index}.size,
+        false,
+        protocol::Handler::WriteConfirmation::DEFAULT,
+        protocol::Handler::Buffer8{},
+        false,
+        0};
+}
+
+template <typename T>
+inline RawItem raw_write(
+    uint16_t index, uint8_t sub_index, T value,
+    protocol::Handler::WriteConfirmation confirmation =
+        protocol::Handler::WriteConfirmation::DEFAULT) {
+    static_assert(
+        std::is_integral<T>::value && std::is_unsigned<T>::value
+            && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8),
+        "Raw values are unsigned integers of 1, 2, 4 or 8 bytes");
+    return RawItem{
+        index,
+        sub_index,
+        protocol::Handler::StorageInfo{sizeof(T), index, sub_index}.size,
+        true,
+        confirmation,
+        protocol::Handler::Buffer8{value},
+        false,
+        0};
+}
+
+} // namespace device
+} // namespace wujihandcpp
@@ -4,7 +4,9 @@
 #include <cstdint>
 #include <cstring>
 
+#include <atomic>
 #include <chrono>
+#include <limits>
 #include <type_traits>
 
 #include "wujihandcpp/device/controller.hpp"
@@ -32,6 +34,8 @@ public:
         uint8_t sub_index;
 
         enum class Size : uint32_t { _1, _2, _4, _8 } size : 2;
+        // Values cross the handler as raw device values. Except for MASKED, the policies only
+        // describe the conversions, which `DataOperator` resolves at compile time.
         enum Policy : uint32_t {
             NONE = 0,
             MASKED = 1ul << 0,
@@ -69,9 +73,110 @@ public:
         static_assert(sizeof(void*) == 8, "");
     };
 
+    enum class WriteConfirmation : uint8_t {
+        DEFAULT,     // Use the policy of the storage unit, see `set_write_confirmation`
+        CONFIRMED,   // Read the value back until it matches
+        UNCONFIRMED, // Treat the write acknowledgement as final
+    };
+
+    // One operation of a transaction, see `transact_async`.
+    struct TransactionItem {
+        int storage_id;
+        bool write;
+        WriteConfirmation confirmation;
+        Buffer8 data; // The value to write; for reads, the value read
+
+        // Filled in before the transaction completes.
+        bool success;
+        uint32_t error_code;
+    };
+
+    // One operation on an arbitrary object of the device dictionary, see `raw_transact_async`.
+    struct RawItem {
+        uint16_t index;
+        uint8_t sub_index;
+        StorageInfo::Size size;
+        bool write;
+        WriteConfirmation confirmation;
+        Buffer8 data; // The raw value to write; for reads, the raw value read
+
+        // Filled in before the batch completes.
+        bool success;
+        uint32_t error_code;
+    };
+
+    struct SdoStatistics {
+        uint64_t read_requests;
+        uint64_t read_back_requests;
+        uint64_t write_requests;
+
+        uint64_t completed_reads;
+        uint64_t completed_confirmed_writes;
+        uint64_t completed_unconfirmed_writes;
+        uint64_t timed_out_operations;
+        uint64_t failed_operations;
+    };
+
+    // USB bytes transmitted per frame type, framing and padding included.
+    struct TrafficStatistics {
+        uint64_t sdo_bytes;
+        uint64_t pdo_bytes;
+        uint64_t sdo_bytes_per_second; // Over the last second
+        uint64_t pdo_bytes_per_second;
+        uint64_t deferred_sdo_requests; // SDO requests held back a tick by the bandwidth limit
+    };
+
+    // Round-trip time estimate over SDO requests answered without retransmission (RFC 6298).
+    struct RttStatistics {
+        std::chrono::steady_clock::duration smoothed_rtt;
+        std::chrono::steady_clock::duration rtt_variance;
+        std::chrono::steady_clock::duration retransmission_timeout;
+        uint64_t samples;
+    };
+
+    // Interval of the empty SDO frames sent while there are no requests.
+    static constexpr std::chrono::milliseconds default_heartbeat_interval{100};
+
+    // SDO request bytes per second allowed while the PDO lane is active (0: no limit).
+    static constexpr uint32_t default_sdo_bandwidth_limit = 0;
+
+    // Timeout value that lets the handler derive the timeout from the measured round-trip time.
+    static constexpr std::chrono::steady_clock::duration::rep adaptive_timeout =
+        std::numeric_limits<std::chrono::steady_clock::duration::rep>::min();
+
+    struct Completion {
+        uint64_t token;
+        bool success;
+        uint32_t error_code;
+    };
+
+    // Callback that queues the completion for `poll_completions` instead of running code on the
+    // tick thread. The callback context is the 64-bit token reported back.
+    WUJIHANDCPP_API static void
+        queue_completion(Buffer8 context, bool success, uint32_t error_code);
+
+    // Holds a callback too large for a `Buffer8` context, in a slab preallocated at construction,
+    // so that attaching it does not allocate. Pass `complete_slot` as the callback and the slot
+    // as its context.
+    struct CompletionSlot {
+        static constexpr size_t capacity = 64;
+
+        alignas(std::max_align_t) unsigned char storage[capacity];
+        // Invokes, then destroys the callback in `storage`.
+        void (*complete)(CompletionSlot& slot, bool success, uint32_t error_code);
+        // Destroys the callback without invoking it.
+        void (*discard)(CompletionSlot& slot);
+
+        std::atomic<bool> busy;
+    };
+
+    static constexpr size_t default_completion_slot_count = 256;
+
+    WUJIHANDCPP_API static void complete_slot(Buffer8 context, bool success, uint32_t error_code);
+
     WUJIHANDCPP_API explicit Handler(
         uint16_t usb_vid, int32_t usb_pid, const char* serial_number, size_t buffer_transfer_count,
-        size_t storage_unit_count);
+        size_t storage_unit_count, size_t completion_slot_count = default_completion_slot_count);
 
     WUJIHANDCPP_API ~Handler();
 
@@ -80,16 +185,83 @@ public:
     WUJIHANDCPP_API void
         read_async_unchecked(int storage_id, std::chrono::steady_clock::duration::rep timeout);
 
+    // Submits `count` unchecked reads in one call, waking the tick thread once.
+    WUJIHANDCPP_API void read_async_unchecked_bulk(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep timeout);
+
     WUJIHANDCPP_API void read_async(
         int storage_id, std::chrono::steady_clock::duration::rep timeout,
-        void (*callback)(Buffer8 context, bool success), Buffer8 callback_context);
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context);
+
+    WUJIHANDCPP_API void read_async_bulk(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context);
 
     WUJIHANDCPP_API void write_async_unchecked(
-        Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout);
+        Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT);
+
+    // Submits `count` unchecked writes of the raw values in `data` in one call.
+    WUJIHANDCPP_API void write_async_unchecked_bulk(
+        const Buffer8* data, const int* storage_ids, size_t count,
+        std::chrono::steady_clock::duration::rep timeout,
+        WriteConfirmation confirmation = WriteConfirmation::DEFAULT);
+
+    // Most writes `write_immediately` takes, all of which fit in its single frame.
+    static constexpr size_t max_immediate_write_count = 32;
+    // Longest wait of `write_immediately`, also used for negative timeouts.
+    static constexpr std::chrono::steady_clock::duration::rep max_immediate_write_timeout =
+        std::chrono::steady_clock::duration{std::chrono::seconds(1)}.count();
+
+    // Sends the writes in one frame at once, ahead of the operation queues, and also submits
+    // them as unchecked writes. Writes still queued on those storage units are dropped and fail,
+    // and sent unconfirmed writes are cancelled, so that they cannot undo these. Returns the
+    // time until the frame was transmitted, or -1 if it was not transmitted within `timeout`,
+    // which waits for a free transfer as well. `count` must be at least 1.
+    WUJIHANDCPP_API std::chrono::steady_clock::duration::rep write_immediately(
+        const Buffer8* data, const int* storage_ids, size_t count,
+        std::chrono::steady_clock::duration::rep timeout);
 
     WUJIHANDCPP_API void write_async(
         Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
-        void (*callback)(Buffer8 context, bool success), Buffer8 callback_context);
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, WriteConfirmation confirmation = WriteConfirmation::DEFAULT);
+
+    WUJIHANDCPP_API void write_async_bulk(
+        const Buffer8* data, const int* storage_ids, size_t count,
+        std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, WriteConfirmation confirmation = WriteConfirmation::DEFAULT);
+
+    WUJIHANDCPP_API void transact_async(
+        TransactionItem* items, size_t count, std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context);
+
+    WUJIHANDCPP_API void raw_transact_async(
+        RawItem* items, size_t count, std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context);
+
+    // Returns nullptr if every slot is in use.
+    WUJIHANDCPP_API CompletionSlot* acquire_completion_slot();
+
+    // Releases a slot whose operation could not be submitted, discarding its callback.
+    WUJIHANDCPP_API static void discard_completion_slot(CompletionSlot* slot);
+
+    WUJIHANDCPP_API size_t poll_completions(
+        Completion* completions, size_t max_count,
+        std::chrono::steady_clock::duration::rep timeout);
+
+    WUJIHANDCPP_API void
+        set_write_confirmation(const int* storage_ids, size_t count, bool confirmed);
+
+    WUJIHANDCPP_API void subscribe(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep period);
+
+    WUJIHANDCPP_API void set_heartbeat_interval(std::chrono::steady_clock::duration::rep interval);
 
     WUJIHANDCPP_API void
         attach_realtime_controller(device::IRealtimeController* controller, bool enable_upstream);
@@ -98,6 +270,41 @@ public:
 
     WUJIHANDCPP_API Buffer8 get(int storage_id);
 
+    // Copies the cached values of `count` storage units while no received frame is being
+    // applied, so that the values of each frame are copied all or none.
+    WUJIHANDCPP_API void get_consistent(const int* storage_ids, size_t count, Buffer8* values);
+
+    WUJIHANDCPP_API Buffer8 get_with_version(int storage_id, uint32_t& version);
+
+    // Seeds the cache with a value known from elsewhere (such as a snapshot), as if it had just
+    // been read. Must not race with an operation on the same object.
+    WUJIHANDCPP_API void restore_value(int storage_id, Buffer8 value);
+
+    WUJIHANDCPP_API std::chrono::steady_clock::duration::rep get_update_point(int storage_id);
+
+    WUJIHANDCPP_API size_t select_stale(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep max_age,
+        int* stale_storage_ids);
+
+    WUJIHANDCPP_API void get_versions(const int* storage_ids, size_t count, uint32_t* versions);
+
+    WUJIHANDCPP_API bool wait_for_update(
+        const int* storage_ids, const uint32_t* versions, size_t count,
+        std::chrono::steady_clock::duration::rep timeout);
+
+    WUJIHANDCPP_API SdoStatistics sdo_statistics();
+
+    WUJIHANDCPP_API TrafficStatistics traffic_statistics();
+
+    WUJIHANDCPP_API void set_sdo_bandwidth_limit(uint32_t bytes_per_second);
+
+    WUJIHANDCPP_API RttStatistics rtt_statistics();
+
+    // USB serial number of the opened device, empty if it could not be read.
+    WUJIHANDCPP_API const char* serial_number();
+
+    // Kept for compatibility and does nothing: operations may be issued from any thread.
+    [[deprecated("Operations may be issued from any thread; this call does nothing.")]]
     WUJIHANDCPP_API void disable_thread_safe_check();
 
 private:
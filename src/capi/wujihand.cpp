@@ -0,0 +1,368 @@
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <wujihandcpp/capi/wujihand.h>
+#include <wujihandcpp/data/joint.hpp>
+#include <wujihandcpp/device/hand.hpp>
+#include <wujihandcpp/device/latch.hpp>
+#include <wujihandcpp/device/selection.hpp>
+#include <wujihandcpp/device/transaction.hpp>
+
+struct wujihand_hand {
+    explicit wujihand_hand(const char* serial_number, int32_t usb_pid, uint16_t usb_vid)
+        : hand(serial_number, usb_pid, usb_vid) {}
+
+    wujihandcpp::device::Hand hand;
+};
+
+namespace wujihandcpp::capi {
+
+namespace {
+
+thread_local std::string last_error;
+
+int32_t fail(int32_t status, const char* what) {
+    last_error = what;
+    return status;
+}
+
+// Exceptions must not cross the C boundary.
+template <typename F>
+auto guarded(F&& f) noexcept -> decltype(f()) {
+    try {
+        return f();
+    } catch (const device::SdoError& error) {
+        return fail(WUJIHAND_ERROR_SDO, error.what());
+    } catch (const device::TimeoutError& error) {
+        return fail(WUJIHAND_ERROR_TIMEOUT, error.what());
+    } catch (const std::invalid_argument& error) {
+        return fail(WUJIHAND_ERROR_INVALID_ARGUMENT, error.what());
+    } catch (const std::exception& error) {
+        return fail(WUJIHAND_ERROR_FAILED, error.what());
+    } catch (...) {
+        return fail(WUJIHAND_ERROR_FAILED, "Unknown error");
+    }
+}
+
+template <typename Data>
+struct DataTag {
+    using type = Data;
+};
+
+// Calls `f` with the `DataTag` of the joint data `data` names.
+template <typename F>
+int32_t visit_joint_data(int32_t data, F&& f) {
+    using namespace data::joint;
+    switch (data) {
+    case WUJIHAND_JOINT_HARDWARE_VERSION: return f(DataTag<HardwareVersion>{});
+    case WUJIHAND_JOINT_HARDWARE_DATE: return f(DataTag<HardwareDate>{});
+    case WUJIHAND_JOINT_CONTROL_MODE: return f(DataTag<ControlMode>{});
+    case WUJIHAND_JOINT_SIN_LEVEL: return f(DataTag<SinLevel>{});
+    case WUJIHAND_JOINT_CURRENT_LIMIT: return f(DataTag<CurrentLimit>{});
+    case WUJIHAND_JOINT_BUS_VOLTAGE: return f(DataTag<BusVoltage>{});
+    case WUJIHAND_JOINT_TEMPERATURE: return f(DataTag<Temperature>{});
+    case WUJIHAND_JOINT_RESET_ERROR: return f(DataTag<ResetError>{});
+    case WUJIHAND_JOINT_ERROR_CODE: return f(DataTag<ErrorCode>{});
+    case WUJIHAND_JOINT_ENABLED: return f(DataTag<Enabled>{});
+    case WUJIHAND_JOINT_ACTUAL_POSITION: return f(DataTag<ActualPosition>{});
+    case WUJIHAND_JOINT_TARGET_POSITION: return f(DataTag<TargetPosition>{});
+    case WUJIHAND_JOINT_UPPER_LIMIT: return f(DataTag<UpperLimit>{});
+    case WUJIHAND_JOINT_LOWER_LIMIT: return f(DataTag<LowerLimit>{});
+    default: throw std::invalid_argument("Unknown joint data: " + std::to_string(data));
+    }
+}
+
+// A negative timeout selects the default of the call; one too long to represent waits without
+// limit.
+std::chrono::steady_clock::duration to_timeout(
+    int64_t timeout_us,
+    std::chrono::steady_clock::duration default_timeout = device::Hand::default_timeout) {
+    using Duration = std::chrono::steady_clock::duration;
+    if (timeout_us < 0)
+        return default_timeout;
+    // Compared in microseconds, as the conversion to the clock resolution may overflow.
+    if (timeout_us >= std::chrono::duration_cast<std::chrono::microseconds>(Duration::max()).count())
+        return Duration::max();
+    return std::chrono::microseconds(timeout_us);
+}
+
+void check_arguments(const wujihand_hand* hand, uint32_t mask) {
+    if (!hand)
+        throw std::invalid_argument("Hand must not be null.");
+    if (!mask || (mask & ~uint32_t(WUJIHAND_ALL_JOINTS)))
+        throw std::invalid_argument("Joint mask must select 1 to 20 joints.");
+}
+
+template <typename Data>
+void check_access(bool write) {
+    if (write && !Data::writable)
+        throw std::invalid_argument("Joint data is read-only.");
+    if (!write && !Data::readable)
+        throw std::invalid_argument("Joint data is write-only.");
+}
+
+// Values come from bindings unchecked, and converting one the type cannot hold is undefined.
+template <typename Data>
+typename Data::ValueType from_double(double value) {
+    using T = typename Data::ValueType;
+    bool representable;
+    if constexpr (std::is_same_v<T, bool>)
+        representable = !std::isnan(value);
+    else if constexpr (std::is_integral_v<T>)
+        // Conversion truncates, so the bounds are exclusive and one step beyond the limits.
+        representable = value > double(std::numeric_limits<T>::lowest()) - 1
+                     && value < double(std::numeric_limits<T>::max()) + 1;
+    else
+        representable = std::isfinite(value) && std::abs(value) <= std::numeric_limits<T>::max();
+    if (!representable)
+        throw std::invalid_argument("Joint value out of range: " + std::to_string(value));
+
+    if constexpr (std::is_same_v<T, bool>)
+        return value != 0;
+    else
+        return static_cast<T>(value);
+}
+
+// Converts the joint-indexed `values` of the masked joints into selection order.
+template <typename Data>
+void gather(uint32_t mask, const double* values, typename Data::ValueType* selected) {
+    if (!values)
+        throw std::invalid_argument("Values must not be null.");
+    size_t count = 0;
+    for (int i = 0; i < WUJIHAND_JOINT_COUNT; i++)
+        if (mask & (uint32_t(1) << i))
+            selected[count++] = from_double<Data>(values[i]);
+}
+
+} // namespace
+
+} // namespace wujihandcpp::capi
+
+using namespace wujihandcpp;
+using namespace wujihandcpp::capi;
+
+extern "C" {
+
+WUJIHANDCPP_API int32_t wujihand_abi_version(void) { return WUJIHAND_ABI_VERSION; }
+
+WUJIHANDCPP_API const char* wujihand_last_error(void) { return last_error.c_str(); }
+
+WUJIHANDCPP_API int32_t wujihand_open(
+    const char* serial_number, int32_t usb_pid, uint16_t usb_vid, wujihand_hand** hand) {
+    return guarded([&]() {
+        if (!hand)
+            throw std::invalid_argument("Hand pointer must not be null.");
+        *hand = new wujihand_hand(serial_number, usb_pid, usb_vid);
+        return int32_t(WUJIHAND_OK);
+    });
+}
+
+WUJIHANDCPP_API void wujihand_close(wujihand_hand* hand) {
+    // The destructor of `Hand` does not throw.
+    delete hand;
+}
+
+WUJIHANDCPP_API int32_t
+    wujihand_read(wujihand_hand* hand, int32_t data, uint32_t mask, int64_t timeout_us) {
+    return guarded([&]() {
+        check_arguments(hand, mask);
+        return visit_joint_data(data, [&](auto tag) {
+            using Data = typename decltype(tag)::type;
+            check_access<Data>(false);
+            if constexpr (Data::readable)
+                hand->hand.select<Data>(mask).read(to_timeout(timeout_us));
+            return int32_t(WUJIHAND_OK);
+        });
+    });
+}
+
+WUJIHANDCPP_API int32_t wujihand_get(wujihand_hand* hand, int32_t data, double* values) {
+    return guarded([&]() {
+        check_arguments(hand, WUJIHAND_ALL_JOINTS);
+        if (!values)
+            throw std::invalid_argument("Values must not be null.");
+        return visit_joint_data(data, [&](auto tag) {
+            using Data = typename decltype(tag)::type;
+            typename Data::ValueType snapshot[5][4];
+            hand->hand.get_all<Data>(snapshot);
+            for (int i = 0; i < WUJIHAND_JOINT_COUNT; i++)
+                values[i] = static_cast<double>(snapshot[i / 4][i % 4]);
+            return int32_t(WUJIHAND_OK);
+        });
+    });
+}
+
+WUJIHANDCPP_API int32_t wujihand_write(
+    wujihand_hand* hand, int32_t data, uint32_t mask, const double* values, int64_t timeout_us) {
+    return guarded([&]() {
+        check_arguments(hand, mask);
+        return visit_joint_data(data, [&](auto tag) {
+            using Data = typename decltype(tag)::type;
+            check_access<Data>(true);
+            if constexpr (Data::writable) {
+                typename Data::ValueType selected[WUJIHAND_JOINT_COUNT];
+                gather<Data>(mask, values, selected);
+                hand->hand.select<Data>(mask).write(selected, to_timeout(timeout_us));
+            }
+            return int32_t(WUJIHAND_OK);
+        });
+    });
+}
+
+WUJIHANDCPP_API int32_t wujihand_write_unchecked(
+    wujihand_hand* hand, int32_t data, uint32_t mask, const double* values, int64_t timeout_us) {
+    return guarded([&]() {
+        check_arguments(hand, mask);
+        return visit_joint_data(data, [&](auto tag) {
+            using Data = typename decltype(tag)::type;
+            check_access<Data>(true);
+            if constexpr (Data::writable) {
+                typename Data::ValueType selected[WUJIHAND_JOINT_COUNT];
+                gather<Data>(mask, values, selected);
+                hand->hand.select<Data>(mask).write_unchecked(selected, to_timeout(timeout_us));
+            }
+            return int32_t(WUJIHAND_OK);
+        });
+    });
+}
+
+WUJIHANDCPP_API int32_t wujihand_read_async(
+    wujihand_hand* hand, int32_t data, uint32_t mask, int64_t timeout_us, uint64_t token) {
+    return guarded([&]() {
+        check_arguments(hand, mask);
+        return visit_joint_data(data, [&](auto tag) {
+            using Data = typename decltype(tag)::type;
+            check_access<Data>(false);
+            if constexpr (Data::readable)
+                hand->hand.select<Data>(mask).read_async(
+                    device::CompletionToken{token}, to_timeout(timeout_us));
+            return int32_t(WUJIHAND_OK);
+        });
+    });
+}
+
+WUJIHANDCPP_API int32_t wujihand_write_async(
+    wujihand_hand* hand, int32_t data, uint32_t mask, const double* values, int64_t timeout_us,
+    uint64_t token) {
+    return guarded([&]() {
+        check_arguments(hand, mask);
+        return visit_joint_data(data, [&](auto tag) {
+            using Data = typename decltype(tag)::type;
+            check_access<Data>(true);
+            if constexpr (Data::writable) {
+                typename Data::ValueType selected[WUJIHAND_JOINT_COUNT];
+                gather<Data>(mask, values, selected);
+                hand->hand.select<Data>(mask).write_async(
+                    device::CompletionToken{token}, selected, to_timeout(timeout_us));
+            }
+            return int32_t(WUJIHAND_OK);
+        });
+    });
+}
+
+WUJIHANDCPP_API int64_t wujihand_poll_completions(
+    wujihand_hand* hand, wujihand_completion* completions, size_t max_count,
+    int64_t timeout_us) {
+    return guarded([&]() -> int64_t {
+        if (!hand || (!completions && max_count))
+            throw std::invalid_argument("Hand and completions must not be null.");
+
+        // Collected in chunks, as the C++ completion has another layout.
+        constexpr size_t chunk_size = 64;
+        device::Completion chunk[chunk_size];
+        auto timeout = to_timeout(timeout_us, std::chrono::steady_clock::duration::zero());
+        size_t count = 0;
+        while (count < max_count) {
+            size_t polled = hand->hand.poll_completions(
+                chunk, std::min(chunk_size, max_count - count),
+                count ? std::chrono::steady_clock::duration::zero() : timeout);
+            for (size_t i = 0; i < polled; i++, count++)
+                completions[count] = wujihand_completion{
+                    chunk[i].token, chunk[i].error_code, uint8_t(chunk[i].success)};
+            if (polled < chunk_size)
+                break;
+        }
+        return int64_t(count);
+    });
+}
+
+WUJIHANDCPP_API int32_t
+    wujihand_execute(wujihand_hand* hand, wujihand_item* items, size_t count, int64_t timeout_us) {
+    return guarded([&]() {
+        if (!hand || (!items && count))
+            throw std::invalid_argument("Hand and items must not be null.");
+
+        device::Transaction transaction;
+        for (size_t i = 0; i < count; i++) {
+            auto& item = items[i];
+            if (item.joint < 0 || item.joint >= WUJIHAND_JOINT_COUNT)
+                throw std::invalid_argument("Joint index out of bounds: 0 to 19.");
+            auto joint = hand->hand.finger(item.joint / 4).joint(item.joint % 4);
+            visit_joint_data(item.data, [&](auto tag) {
+                using Data = typename decltype(tag)::type;
+                check_access<Data>(item.write);
+                if constexpr (Data::writable) {
+                    if (item.write)
+                        joint.template stage_write<Data>(
+                            transaction, from_double<Data>(item.value));
+                }
+                if constexpr (Data::readable) {
+                    if (!item.write)
+                        joint.template stage_read<Data>(transaction);
+                }
+                return int32_t(WUJIHAND_OK);
+            });
+        }
+
+        device::Latch latch;
+        hand->hand.execute_async(latch, transaction, to_timeout(timeout_us));
+        // Every item carries its own result, so the aggregate error is reported as a count.
+        bool succeeded = latch.try_wait();
+
+        size_t failed = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto& item = items[i];
+            item.success = transaction[i].success;
+            item.error_code = transaction[i].error_code;
+            if (!item.success)
+                failed++;
+            else if (!item.write)
+                visit_joint_data(item.data, [&](auto tag) {
+                    using Data = typename decltype(tag)::type;
+                    item.value = static_cast<double>(transaction.value<Data>(i));
+                    return int32_t(WUJIHAND_OK);
+                });
+        }
+        if (!succeeded)
+            return fail(
+                WUJIHAND_ERROR_FAILED,
+                (std::to_string(failed) + " of " + std::to_string(count) + " items failed")
+                    .c_str());
+        return int32_t(WUJIHAND_OK);
+    });
+}
+
+WUJIHANDCPP_API int32_t
+    wujihand_emergency_stop(wujihand_hand* hand, int64_t timeout_us, int64_t* latency_us) {
+    return guarded([&]() {
+        if (!hand)
+            throw std::invalid_argument("Hand must not be null.");
+        auto latency = hand->hand.emergency_stop(
+            to_timeout(timeout_us, device::Hand::emergency_stop_timeout));
+        if (latency_us)
+            *latency_us =
+                std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        return int32_t(WUJIHAND_OK);
+    });
+}
+
+} // extern "C"
@@ -1,29 +1,137 @@
+#include <algorithm>
+#include <format>
+#include <thread>
+
 #include <wujihandcpp/device/latch.hpp>
 #include <wujihandcpp/utility/api.hpp>
 
+#include "utility/cross_os.hpp"
+#include "utility/futex.hpp"
+
 namespace wujihandcpp::device {
 
-WUJIHANDCPP_API int Latch::try_wait_internal() noexcept {
-    int current = waiting_count_.load(std::memory_order_acquire);
-    while (current != 0) {
-        waiting_count_.wait(current, std::memory_order_acquire);
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Synchronous SDO replies typically arrive within a few hundred microseconds, where a futex sleep
+// and wakeup is a large part of the latency. Waits therefore spin first, for twice the expected
+// wait, as long as that stays within the limit. The expected wait is a moving average of how long
+// recent waits took, whether they spun or blocked, shared by all latches. So slow operations
+// soon stop burning CPU, and spinning resumes once they are fast again.
+constexpr Clock::duration default_spin_limit = std::chrono::microseconds(200);
+constexpr Clock::duration initial_expected_wait = std::chrono::microseconds(100);
+
+// Spinning cannot help without a second core to complete the operation on.
+std::atomic<Clock::rep> spin_limit{
+    std::thread::hardware_concurrency() > 1 ? default_spin_limit.count() : 0};
+std::atomic<Clock::rep> expected_wait{initial_expected_wait.count()};
+
+Clock::rep spin_budget_within(Clock::rep limit) {
+    auto expected = expected_wait.load(std::memory_order_relaxed);
+    if (expected > limit)
+        return 0;
+    return std::min(2 * expected, limit);
+}
+
+// Races between waiters only lose a sample.
+void record_wait(Clock::duration wait) {
+    auto expected = expected_wait.load(std::memory_order_relaxed);
+    expected_wait.store(expected + (wait.count() - expected) / 8, std::memory_order_relaxed);
+}
+
+} // namespace
+
+WUJIHANDCPP_API void Latch::set_spin_limit(std::chrono::steady_clock::duration limit) noexcept {
+    auto count = std::max(limit, Clock::duration::zero()).count();
+    spin_limit.store(count, std::memory_order_relaxed);
+}
+
+WUJIHANDCPP_API std::chrono::steady_clock::duration Latch::spin_budget() noexcept {
+    return Clock::duration{spin_budget_within(spin_limit.load(std::memory_order_relaxed))};
+}
+
+WUJIHANDCPP_API int Latch::try_wait_internal(uint32_t& error_code) noexcept {
+    return try_wait_internal(Clock::time_point::max(), error_code);
+}
+
+WUJIHANDCPP_API int
+    Latch::try_wait_internal(Clock::time_point deadline, uint32_t& error_code) noexcept {
+    auto current = waiting_count_.load(std::memory_order_acquire);
+    if (!(current & ~sleeping_flag)) {
+        error_code = error_code_.exchange(0, std::memory_order_relaxed);
+        return error_count_.exchange(0, std::memory_order_relaxed);
+    }
+
+    const auto begin = Clock::now();
+    auto budget = spin_budget_within(spin_limit.load(std::memory_order_relaxed));
+    if (budget > 0) {
+        const auto spin_deadline = std::min(begin + Clock::duration(budget), deadline);
+        // Reading the clock costs more than a pause, so only check it every few rounds.
+        for (int round = 1; current & ~sleeping_flag; round++) {
+            utility::cpu_relax();
+            current = waiting_count_.load(std::memory_order_acquire);
+            if (round % 16 == 0 && Clock::now() >= spin_deadline)
+                break;
+        }
+    }
+
+    while (current & ~sleeping_flag) {
+        // Announce the sleep in the counter itself, so that `count_down` learns of it from its own
+        // read-modify-write. After the final decrement, `count_down` only passes the address of
+        // the counter to the wake call, which does not access it, so the waiter may destroy the
+        // latch as soon as it sees the count reach zero.
+        if (!(current & sleeping_flag)
+            && !waiting_count_.compare_exchange_weak(
+                current, current | sleeping_flag, std::memory_order_acquire))
+            continue;
+
+        auto remaining = Clock::duration{-1};
+        if (deadline != Clock::time_point::max()) {
+            remaining = deadline - Clock::now();
+            if (remaining <= Clock::duration::zero())
+                return -1;
+        }
+        utility::futex_wait(waiting_count_, current | sleeping_flag, remaining);
         current = waiting_count_.load(std::memory_order_acquire);
     }
+    if (current & sleeping_flag)
+        waiting_count_.fetch_and(~sleeping_flag, std::memory_order_relaxed);
+    // Waits that gave up at their deadline say nothing about how long operations take.
+    record_wait(Clock::now() - begin);
 
+    error_code = error_code_.exchange(0, std::memory_order_relaxed);
     return error_count_.exchange(0, std::memory_order_relaxed);
 }
 
+WUJIHANDCPP_API void Latch::throw_sdo_error(int error_count, uint32_t error_code) {
+    if (error_count == 1)
+        throw SdoError(
+            std::format("Operation rejected by device: SDO error 0x{:08X}", error_code),
+            error_code);
+    else
+        throw SdoError(
+            std::format(
+                "{} operations failed while waiting for completion, first SDO error 0x{:08X}",
+                error_count, error_code),
+            error_code);
+}
+
 WUJIHANDCPP_API void Latch::count_up() noexcept {
     waiting_count_.fetch_add(1, std::memory_order_relaxed);
 }
 
-WUJIHANDCPP_API void Latch::count_down(bool success) noexcept {
+WUJIHANDCPP_API void Latch::count_down(bool success, uint32_t error_code) noexcept {
     if (!success)
         error_count_.fetch_add(1, std::memory_order_relaxed);
+    if (error_code) {
+        uint32_t expected = 0;
+        error_code_.compare_exchange_strong(expected, error_code, std::memory_order_relaxed);
+    }
 
-    const int old = waiting_count_.fetch_sub(1, std::memory_order_release);
-    if (old - 1 == 0)
-        waiting_count_.notify_one();
+    const auto old = waiting_count_.fetch_sub(1, std::memory_order_release);
+    if (old == (sleeping_flag | 1))
+        utility::futex_wake_all(waiting_count_);
 }
 
 } // namespace wujihandcpp::device
\ No newline at end of file
@@ -128,6 +128,9 @@ public:
         }
     }
 
+    // Only meaningful on the thread that fetches buffers.
+    bool has_free_transfer() { return free_transfers_.front() != nullptr; }
+
     bool trigger_transmission(bool allow_empty = false) {
         auto front = free_transfers_.front();
         if (!front)
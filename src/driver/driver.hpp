@@ -6,6 +6,8 @@
 #include <cstring>
 #include <format>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <libusb.h>
@@ -64,6 +66,12 @@ public:
         }
     }
 
+    // Of the opened device, empty if it could not be read.
+    const std::string& serial_number() const { return serial_number_; }
+
+    // Largest frame a transmit transfer holds, header and CRC included.
+    static constexpr int max_transmit_length() { return max_transmit_length_; }
+
     void stop_handling_events() {
         handling_events_.store(false, std::memory_order::relaxed);
         libusb_cancel_transfer(libusb_receive_transfer_);
@@ -145,6 +153,7 @@ private:
             [&device_descriptors]() { delete[] device_descriptors; }};
 
         std::vector<libusb_device_handle*> devices_opened;
+        std::vector<std::string> serial_numbers_opened;
 
         for (ssize_t i = 0; i < device_count; i++) {
             int ret = libusb_get_device_descriptor(device_list[i], &device_descriptors[i]);
@@ -168,20 +177,23 @@ private:
                 continue;
             utility::FinalAction close_device{[&handle]() { libusb_close(handle); }};
 
-            if (serial_number) {
-                unsigned char serial_buf[256];
-                int n = libusb_get_string_descriptor_ascii(
-                    handle, descriptors.iSerialNumber, serial_buf, sizeof(serial_buf) - 1);
-                if (n < 0)
-                    continue;
-                serial_buf[n] = '\0';
-
-                if (strcmp(reinterpret_cast<char*>(serial_buf), serial_number) != 0)
+            // Also read without a filter, to identify the selected device, see `serial_number`.
+            unsigned char serial_buf[256];
+            int n = libusb_get_string_descriptor_ascii(
+                handle, descriptors.iSerialNumber, serial_buf, sizeof(serial_buf) - 1);
+            if (n < 0) {
+                if (serial_number)
                     continue;
+                n = 0;
             }
+            serial_buf[n] = '\0';
+
+            if (serial_number && strcmp(reinterpret_cast<char*>(serial_buf), serial_number) != 0)
+                continue;
 
             close_device.disable();
             devices_opened.push_back(handle);
+            serial_numbers_opened.emplace_back(reinterpret_cast<char*>(serial_buf));
         }
 
         if (devices_opened.size() != 1) {
@@ -217,6 +229,7 @@ private:
         }
 
         libusb_device_handle_ = devices_opened[0];
+        serial_number_ = std::move(serial_numbers_opened[0]);
         return true;
     }
 
@@ -329,6 +342,7 @@ private:
 
     libusb_context* libusb_context_;
     libusb_device_handle* libusb_device_handle_;
+    std::string serial_number_;
 
     libusb_transfer* libusb_receive_transfer_;
     std::byte receive_buffer_[max_receive_length_];
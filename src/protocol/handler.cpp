@@ -7,13 +7,16 @@
 #include <atomic>
 #include <bit>
 #include <chrono>
+#include <deque>
 #include <format>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numbers>
 #include <stdexcept>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <spdlog/fmt/bin_to_hex.h>
 #include <wujihandcpp/protocol/handler.hpp>
@@ -21,8 +24,13 @@
 
 #include "driver/async_transmit_buffer.hpp"
 #include "driver/driver.hpp"
+#include "protocol/operation.hpp"
 #include "protocol/protocol.hpp"
+#include "utility/event_count.hpp"
+#include "utility/final_action.hpp"
 #include "utility/logging.hpp"
+#include "utility/mpmc_ring_buffer.hpp"
+#include "utility/ring_buffer.hpp"
 
 namespace wujihandcpp::protocol {
 
@@ -33,17 +41,49 @@ class Handler::Impl : driver::Driver<Impl> {
 public:
     explicit Impl(
         uint16_t usb_vid, int32_t usb_pid, const char* serial_number, size_t buffer_transfer_count,
-        size_t storage_unit_count)
+        size_t storage_unit_count, size_t completion_slot_count)
         : Driver(usb_vid, usb_pid, serial_number)
         , logger_(logging::get_logger())
         , default_transmit_buffer_(*this, buffer_transfer_count)
         , tick_thread_transmit_buffer_(*this, buffer_transfer_count)
+        , emergency_transmit_buffer_(*this, emergency_transfer_count)
         , event_thread_([this]() { handle_events(); })
-        , operation_thread_id_(std::this_thread::get_id())
-        , storage_unit_count_(storage_unit_count)
-        , storage_(std::make_unique<StorageUnit[]>(storage_unit_count))
+        , storage_unit_count_(storage_unit_count + raw_unit_count)
+        , first_raw_unit_(storage_unit_count)
+        , storage_(std::make_unique<StorageUnit[]>(storage_unit_count_))
+        , operation_queues_([this]() {
+            // Filled before the tick thread starts, which scans every queue on each tick.
+            std::deque<utility::MpmcRingBuffer<QueuedOperation>> queues;
+            for (size_t i = 0; i < storage_unit_count_; i++)
+                queues.emplace_back(operation_queue_capacity);
+            return queues;
+        }())
+        , bulk_operations_(
+              std::make_unique<BulkOperation[]>(bulk_operation_count(storage_unit_count_)))
+        , free_bulk_operations_(bulk_operation_count(storage_unit_count_))
+        , subscriptions_(std::make_unique<Subscription[]>(storage_unit_count_))
+        , update_points_(
+              std::make_unique<std::atomic<std::chrono::steady_clock::duration::rep>[]>(
+                  storage_unit_count_))
+        , write_epochs_(std::make_unique<std::atomic<uint32_t>[]>(storage_unit_count_))
+        , retransmissions_(std::make_unique<Retransmission[]>(storage_unit_count_))
+        , raw_unit_keys_(std::make_unique<std::atomic<uint32_t>[]>(raw_unit_count))
+        , raw_unit_batches_(std::make_unique<RawBatch*[]>(raw_unit_count))
+        , submitted_raw_batches_(raw_batch_queue_capacity)
+        , completion_slots_(std::make_unique<CompletionSlot[]>(completion_slot_count))
+        , completion_slot_count_(completion_slot_count)
         , tick_thread_(
-              [this](const std::stop_token& stop_token) { tick_thread_main(stop_token); }) {}
+              [this](const std::stop_token& stop_token) { tick_thread_main(stop_token); }) {
+        // The tick thread only touches bulk operations and raw units once one has been submitted,
+        // which cannot happen before the constructor returns, so filling the free lists here is
+        // race-free.
+        for (uint32_t i = 0; i < bulk_operation_count(storage_unit_count_); i++) {
+            bulk_operations_[i].index = i;
+            free_bulk_operations_.push_back(i);
+        }
+        for (uint32_t i = 0; i < raw_unit_count; i++)
+            free_raw_units_.push_back(i);
+    }
 
     ~Impl() { stop_handling_events(); };
 
@@ -54,69 +94,315 @@ public:
     }
 
     void read_async_unchecked(int storage_id, std::chrono::steady_clock::duration::rep timeout) {
-        operation_thread_check();
-
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE)
-            return;
+        if (submit_unchecked_read(storage_id, timeout))
+            wake_tick_thread();
+    }
 
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = nullptr;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::READ, .state = Operation::State::WAITING},
-            std::memory_order::release);
+    void read_async_unchecked_bulk(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep timeout) {
+        bool submitted = false;
+        for (size_t i = 0; i < count; i++)
+            submitted |= submit_unchecked_read(storage_ids[i], timeout);
+        if (submitted)
+            wake_tick_thread();
     }
 
     void read_async(
         int storage_id, std::chrono::steady_clock::duration::rep timeout,
-        void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
-        operation_thread_check();
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        if (!reserve_completion(callback)) [[unlikely]]
+            throw std::runtime_error("Completion queue is full: drain it with poll_completions!");
+        bool submitted = submit(
+            storage_id, Operation::Mode::READ, Buffer8{}, timeout, callback, callback_context);
+        if (!submitted) [[unlikely]] {
+            cancel_completion(callback);
+            throw std::runtime_error("Illegal checked read: Operation queue is full!");
+        }
+        wake_tick_thread();
+    }
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE) [[unlikely]]
-            throw std::runtime_error("Illegal checked read: Data is being operated!");
-
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = callback;
-        storage_[storage_id].callback_context = callback_context;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::READ, .state = Operation::State::WAITING},
-            std::memory_order::release);
+    void read_async_bulk(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        submit_bulk(
+            count,
+            [storage_ids](size_t i) {
+                return BulkMemberInfo{storage_ids[i], Operation::Mode::READ, Buffer8{}};
+            },
+            nullptr, timeout, callback, callback_context);
     }
 
     void write_async_unchecked(
-        Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout) {
-        operation_thread_check();
+        Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
+        WriteConfirmation confirmation) {
+        if (submit_unchecked_write(data, storage_id, timeout, confirmation))
+            wake_tick_thread();
+    }
 
-        store_data(storage_[storage_id], data);
+    void write_async_unchecked_bulk(
+        const Buffer8* data, const int* storage_ids, size_t count,
+        std::chrono::steady_clock::duration::rep timeout, WriteConfirmation confirmation) {
+        bool submitted = false;
+        for (size_t i = 0; i < count; i++)
+            submitted |= submit_unchecked_write(data[i], storage_ids[i], timeout, confirmation);
+        // Once for all units, so that they leave in the same frames.
+        if (submitted)
+            wake_tick_thread();
+    }
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE)
-            return;
+    std::chrono::steady_clock::duration::rep write_immediately(
+        const Buffer8* data, const int* storage_ids, size_t count,
+        std::chrono::steady_clock::duration::rep timeout) {
+        const auto begin = std::chrono::steady_clock::now();
+        if (!count)
+            throw std::invalid_argument("Immediate writes need at least one storage unit.");
+        if (count > max_immediate_write_count)
+            throw std::invalid_argument("Too many immediate writes to fit in one frame.");
+        // Negative timeouts, `adaptive_timeout` included, would otherwise wait without limit.
+        if (timeout < 0 || timeout > max_immediate_write_timeout)
+            timeout = max_immediate_write_timeout;
+        const auto deadline = begin + std::chrono::steady_clock::duration{timeout};
+        auto remaining = [deadline]() {
+            return std::max(
+                deadline - std::chrono::steady_clock::now(),
+                std::chrono::steady_clock::duration::zero());
+        };
 
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = nullptr;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::WRITE, .state = Operation::State::WAITING},
-            std::memory_order::release);
+        // Writes queued before these, such as a pending enable, would undo them once started.
+        for (size_t i = 0; i < count; i++)
+            write_epochs_[storage_ids[i]].fetch_add(1, std::memory_order::relaxed);
+        // A sent unconfirmed write cannot be superseded, and would be resent until acknowledged.
+        for (size_t i = 0; i < count; i++) {
+            auto& operation = storage_[storage_ids[i]].operation;
+            auto observed = operation.load(std::memory_order::acquire);
+            if (observed.can_be_cancelled())
+                Operation::transition(operation, observed, Operation::State::CANCELLED);
+        }
+
+        uint64_t target = 0; // 0 if no frame was submitted
+        bool transfer_available = false;
+        {
+            // Encoded and submitted on the calling thread, bypassing the tick thread and the
+            // operation queues, so that all units leave in one frame ahead of queued traffic.
+            std::lock_guard guard{emergency_mutex_};
+            transfer_available = wait_for_emergency_transfer(remaining());
+            if (transfer_available) {
+                for (size_t i = 0; i < count; i++) {
+                    const auto& info = storage_[storage_ids[i]].info;
+                    if (info.size == StorageInfo::Size::_1)
+                        write_async_unchecked_internal(
+                            emergency_transmit_buffer_, data[i].as<uint8_t>(), info.index,
+                            info.sub_index);
+                    else if (info.size == StorageInfo::Size::_2)
+                        write_async_unchecked_internal(
+                            emergency_transmit_buffer_, data[i].as<uint16_t>(), info.index,
+                            info.sub_index);
+                    else if (info.size == StorageInfo::Size::_4)
+                        write_async_unchecked_internal(
+                            emergency_transmit_buffer_, data[i].as<uint32_t>(), info.index,
+                            info.sub_index);
+                    else if (info.size == StorageInfo::Size::_8)
+                        write_async_unchecked_internal(
+                            emergency_transmit_buffer_, data[i].as<uint64_t>(), info.index,
+                            info.sub_index);
+                }
+                if (emergency_transmit_buffer_.trigger_transmission())
+                    target = emergency_submitted_.load(std::memory_order::relaxed);
+            }
+        }
+
+        // The frame is not acknowledged, so the same values are also written through the
+        // scheduler, superseding pending writes and retried until the device confirms them.
+        write_async_unchecked_bulk(data, storage_ids, count, timeout, WriteConfirmation::DEFAULT);
+
+        if (!transfer_available)
+            return -1;
+        if (!target) [[unlikely]]
+            throw std::runtime_error("The immediate frame could not be submitted.");
+        auto transmitted = [this, target]() {
+            return emergency_transmitted_.load(std::memory_order::acquire) >= target;
+        };
+        if (!emergency_event_.wait_until(transmitted, remaining()))
+            return -1;
+        return emergency_transmit_point_.load(std::memory_order::relaxed)
+             - begin.time_since_epoch().count();
+    }
+
+    // Under `emergency_mutex_`. Earlier frames may still hold every emergency transfer, and a
+    // stop waits for one to return rather than failing.
+    bool wait_for_emergency_transfer(std::chrono::steady_clock::duration timeout) {
+        auto available = [this]() {
+            return emergency_submitted_.load(std::memory_order::relaxed)
+                     - emergency_transmitted_.load(std::memory_order::acquire)
+                 < emergency_transfer_count;
+        };
+        if (!emergency_event_.wait_until(available, timeout))
+            return false;
+        // A transfer is counted as transmitted just before it is recycled.
+        while (!emergency_transmit_buffer_.has_free_transfer())
+            std::this_thread::yield();
+        return true;
     }
 
     void write_async(
         Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
-        void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
-        operation_thread_check();
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, WriteConfirmation confirmation) {
+        auto& storage = storage_[storage_id];
+        if (!reserve_completion(callback)) [[unlikely]]
+            throw std::runtime_error("Completion queue is full: drain it with poll_completions!");
+        bool submitted = submit(
+            storage_id, write_mode(storage, confirmation), data, timeout, callback,
+            callback_context);
+        if (!submitted) [[unlikely]] {
+            cancel_completion(callback);
+            throw std::runtime_error("Illegal checked write: Operation queue is full!");
+        }
+        wake_tick_thread();
+    }
 
-        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
-            != Operation::Mode::NONE) [[unlikely]]
-            throw std::runtime_error("Illegal checked write: Data is being operated!");
-
-        store_data(storage_[storage_id], data);
-        storage_[storage_id].timeout = std::chrono::steady_clock::duration(timeout);
-        storage_[storage_id].callback = callback;
-        storage_[storage_id].callback_context = callback_context;
-        storage_[storage_id].operation.store(
-            Operation{.mode = Operation::Mode::WRITE, .state = Operation::State::WAITING},
-            std::memory_order::release);
+    void write_async_bulk(
+        const Buffer8* data, const int* storage_ids, size_t count,
+        std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context, WriteConfirmation confirmation) {
+        submit_bulk(
+            count,
+            [this, data, storage_ids, confirmation](size_t i) {
+                auto& storage = storage_[storage_ids[i]];
+                return BulkMemberInfo{
+                    storage_ids[i], write_mode(storage, confirmation), data[i]};
+            },
+            nullptr, timeout, callback, callback_context);
+    }
+
+    void transact_async(
+        TransactionItem* items, size_t count, std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        for (size_t i = 0; i < count; i++) {
+            items[i].success = false;
+            items[i].error_code = 0;
+        }
+        submit_bulk(
+            count,
+            [this, items](size_t i) {
+                const auto& item = items[i];
+                auto& storage = storage_[item.storage_id];
+                if (!item.write)
+                    return BulkMemberInfo{item.storage_id, Operation::Mode::READ, Buffer8{}};
+                return BulkMemberInfo{
+                    item.storage_id, write_mode(storage, item.confirmation), item.data};
+            },
+            items, timeout, callback, callback_context);
+    }
+
+    void raw_transact_async(
+        RawItem* items, size_t count, std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        if (!count) [[unlikely]] {
+            if (callback == &Handler::queue_completion)
+                throw std::invalid_argument("Cannot queue the completion of an empty operation.");
+            callback(callback_context, true, 0);
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            items[i].success = false;
+            items[i].error_code = 0;
+        }
+
+        if (!submitted_raw_batches_.reserve()) [[unlikely]]
+            throw std::runtime_error("Too many raw operation batches in flight!");
+        if (!reserve_completion(callback)) [[unlikely]] {
+            submitted_raw_batches_.release();
+            throw std::runtime_error("Completion queue is full: drain it with poll_completions!");
+        }
+
+        submitted_raw_batches_.emplace_reserved(new RawBatch{
+            .items = items,
+            .count = count,
+            .next = 0,
+            .remaining = count,
+            .failed = false,
+            .error_code = 0,
+            .timeout = timeout,
+            .callback = callback,
+            .callback_context = callback_context,
+        });
+        wake_tick_thread();
+    }
+
+    CompletionSlot* acquire_completion_slot() {
+        // Slots are released in roughly the order they were taken, so the one after the last
+        // taken is usually free.
+        for (size_t k = 0; k < completion_slot_count_; k++) {
+            auto& slot = completion_slots_
+                [next_completion_slot_.fetch_add(1, std::memory_order::relaxed)
+                 % completion_slot_count_];
+            if (!slot.busy.load(std::memory_order::relaxed)
+                && !slot.busy.exchange(true, std::memory_order::acquire))
+                return &slot;
+        }
+        return nullptr;
+    }
+
+    static void complete_slot(Buffer8 context, bool success, uint32_t error_code) {
+        auto& slot = *context.as<CompletionSlot*>();
+        utility::FinalAction release{
+            [&slot]() { slot.busy.store(false, std::memory_order::release); }};
+        slot.complete(slot, success, error_code);
+    }
+
+    static void discard_completion_slot(CompletionSlot* slot) {
+        slot->discard(*slot);
+        slot->busy.store(false, std::memory_order::release);
+    }
+
+    size_t poll_completions(
+        Completion* completions, size_t max_count,
+        std::chrono::steady_clock::duration::rep timeout) {
+        if (!max_count)
+            return 0;
+
+        auto available = [this]() { return completion_queue_.readable() != 0; };
+        if (!completion_event_.wait_until(available, std::chrono::steady_clock::duration{timeout}))
+            return 0;
+
+        auto count = completion_queue_.pop_front_multi(
+            [&completions](Completion&& completion) { *completions++ = completion; }, max_count);
+        completion_reservations_.fetch_sub(count, std::memory_order::relaxed);
+        return count;
+    }
+
+    void set_write_confirmation(const int* storage_ids, size_t count, bool confirmed) {
+        for (size_t i = 0; i < count; i++)
+            storage_[storage_ids[i]].confirm_writes.store(confirmed, std::memory_order::relaxed);
+    }
+
+    void subscribe(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep period) {
+        if (period < 0)
+            throw std::invalid_argument("Subscription period must not be negative.");
+
+        // Stagger the first reads over one period, so that subscribing a whole selection does
+        // not produce a burst of requests every period.
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        for (size_t i = 0; i < count; i++) {
+            auto& subscription = subscriptions_[storage_ids[i]];
+            auto phase = period / static_cast<std::chrono::steady_clock::duration::rep>(count)
+                       * static_cast<std::chrono::steady_clock::duration::rep>(i);
+            subscription.next_point.store(now + phase, std::memory_order::relaxed);
+            subscription.period.store(period, std::memory_order::release);
+        }
+        wake_tick_thread();
+    }
+
+    void set_heartbeat_interval(std::chrono::steady_clock::duration::rep interval) {
+        heartbeat_interval_.store(interval, std::memory_order::relaxed);
+        wake_tick_thread();
     }
 
     void attach_realtime_controller(device::IRealtimeController* controller, bool enable_upstream) {
@@ -141,29 +427,119 @@ public:
         return realtime_controller_.release();
     }
 
-    Buffer8 get(int storage_id) { return load_data(storage_[storage_id]); }
+    Buffer8 get(int storage_id) {
+        return storage_[storage_id].value.load(std::memory_order::relaxed);
+    }
 
-    void disable_thread_safe_check() { operation_thread_id_ = std::thread::id{}; }
+    RttStatistics rtt_statistics() const {
+        auto smoothed_rtt = rtt_.smoothed_rtt();
+        auto rtt_variance = rtt_.rtt_variance();
+        return RttStatistics{
+            .smoothed_rtt = smoothed_rtt,
+            .rtt_variance = rtt_variance,
+            .retransmission_timeout =
+                RttEstimator::retransmission_timeout(smoothed_rtt, rtt_variance),
+            .samples = rtt_.samples.load(std::memory_order::relaxed),
+        };
+    }
 
-private:
-    struct Operation {
-        enum class Mode : uint16_t {
-            NONE = 0,
+    SdoStatistics sdo_statistics() const {
+        return SdoStatistics{
+            .read_requests = statistics_.read_requests.load(std::memory_order::relaxed),
+            .read_back_requests = statistics_.read_back_requests.load(std::memory_order::relaxed),
+            .write_requests = statistics_.write_requests.load(std::memory_order::relaxed),
+            .completed_reads = statistics_.completed_reads.load(std::memory_order::relaxed),
+            .completed_confirmed_writes =
+                statistics_.completed_confirmed_writes.load(std::memory_order::relaxed),
+            .completed_unconfirmed_writes =
+                statistics_.completed_unconfirmed_writes.load(std::memory_order::relaxed),
+            .timed_out_operations =
+                statistics_.timed_out_operations.load(std::memory_order::relaxed),
+            .failed_operations = statistics_.failed_operations.load(std::memory_order::relaxed),
+        };
+    }
 
-            READ,
-            WRITE
-        } mode;
-        enum class State : uint16_t {
-            SUCCESS = 0,
+    TrafficStatistics traffic_statistics() const {
+        return TrafficStatistics{
+            .sdo_bytes = traffic_.sdo_bytes.load(std::memory_order::relaxed),
+            .pdo_bytes = traffic_.pdo_bytes.load(std::memory_order::relaxed),
+            .sdo_bytes_per_second = traffic_.sdo_bytes_per_second.load(std::memory_order::relaxed),
+            .pdo_bytes_per_second = traffic_.pdo_bytes_per_second.load(std::memory_order::relaxed),
+            .deferred_sdo_requests =
+                traffic_.deferred_sdo_requests.load(std::memory_order::relaxed),
+        };
+    }
 
-            WAITING,
+    using Driver::serial_number;
 
-            READING,
+    void set_sdo_bandwidth_limit(uint32_t bytes_per_second) {
+        sdo_bandwidth_limit_.store(bytes_per_second, std::memory_order::relaxed);
+    }
 
-            WRITING,
-            WRITING_CONFIRMING,
-        } state;
-    };
+    void get_consistent(const int* storage_ids, size_t count, Buffer8* values) {
+        // Seqlock read side: retry until no receive pass overlapped the copy. No user code runs
+        // on the event thread, so the writer never waits for a reader.
+        while (true) {
+            auto sequence = receive_sequence_.load(std::memory_order::acquire);
+            if (!(sequence & 1)) {
+                for (size_t i = 0; i < count; i++)
+                    values[i] = storage_[storage_ids[i]].value.load(std::memory_order::relaxed);
+                std::atomic_thread_fence(std::memory_order::acquire);
+                if (receive_sequence_.load(std::memory_order::relaxed) == sequence)
+                    return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    Buffer8 get_with_version(int storage_id, uint32_t& version) {
+        // Version first: the value is then at least as new as the version reported with it.
+        version = storage_[storage_id].version.load(std::memory_order::acquire);
+        return storage_[storage_id].value.load(std::memory_order::relaxed);
+    }
+
+    void restore_value(int storage_id, Buffer8 value) {
+        publish_value(storage_[storage_id], value, std::chrono::steady_clock::now());
+    }
+
+    std::chrono::steady_clock::duration::rep get_update_point(int storage_id) {
+        return update_points_[storage_id].load(std::memory_order::acquire);
+    }
+
+    size_t select_stale(
+        const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep max_age,
+        int* stale_storage_ids) {
+        auto oldest = std::chrono::steady_clock::now().time_since_epoch().count() - max_age;
+
+        size_t stale_count = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto update_point = update_points_[storage_ids[i]].load(std::memory_order::acquire);
+            if (!update_point || update_point < oldest)
+                stale_storage_ids[stale_count++] = storage_ids[i];
+        }
+        return stale_count;
+    }
+
+    void get_versions(const int* storage_ids, size_t count, uint32_t* versions) {
+        for (size_t i = 0; i < count; i++)
+            versions[i] = storage_[storage_ids[i]].version.load(std::memory_order::acquire);
+    }
+
+    bool wait_for_update(
+        const int* storage_ids, const uint32_t* versions, size_t count,
+        std::chrono::steady_clock::duration::rep timeout) {
+        auto all_updated = [&]() {
+            for (size_t i = 0; i < count; i++)
+                if (storage_[storage_ids[i]].version.load(std::memory_order::acquire)
+                    == versions[i])
+                    return false;
+            return true;
+        };
+        return update_event_.wait_until(
+            all_updated, std::chrono::steady_clock::duration{timeout});
+    }
+
+private:
     struct alignas(64) StorageUnit {
         constexpr StorageUnit()
             : version(0) {};
@@ -186,50 +562,503 @@ private:
             static_assert(std::is_trivially_destructible_v<decltype(timeout_point)>);
         };
 
-        void (*callback)(Buffer8 context, bool success);
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code);
         Buffer8 callback_context;
+
+        // Written by the receive thread before the operation state becomes FAILED.
+        uint32_t error_code = 0;
+
+        // Set and read by the issuing threads.
+        std::atomic<bool> confirm_writes = true;
+
+        // Steady clock ticks when the pending request was sent, or 0 once it has been
+        // retransmitted (whose response cannot be attributed to one send, see Karn's algorithm).
+        std::atomic<std::chrono::steady_clock::duration::rep> dispatch_point = 0;
     };
     static_assert(sizeof(StorageUnit) == 64);
 
-    void operation_thread_check() const {
-        if (operation_thread_id_ == std::thread::id{})
+    // Smoothed round-trip time and variance as in RFC 6298. Updated by the receive thread only.
+    struct RttEstimator {
+        static constexpr std::chrono::steady_clock::duration granularity =
+            std::chrono::milliseconds(1);
+
+        std::atomic<std::chrono::steady_clock::duration::rep> smoothed{0};
+        std::atomic<std::chrono::steady_clock::duration::rep> variance{0};
+        std::atomic<uint64_t> samples{0};
+
+        void update(std::chrono::steady_clock::duration sample) {
+            auto r = sample.count();
+            auto srtt = smoothed.load(std::memory_order::relaxed);
+            auto rttvar = variance.load(std::memory_order::relaxed);
+            if (samples.load(std::memory_order::relaxed) == 0) {
+                srtt = r;
+                rttvar = r / 2;
+            } else {
+                rttvar = rttvar - rttvar / 4 + (srtt > r ? srtt - r : r - srtt) / 4;
+                srtt = srtt - srtt / 8 + r / 8;
+            }
+            smoothed.store(srtt, std::memory_order::relaxed);
+            variance.store(rttvar, std::memory_order::relaxed);
+            samples.store(samples.load(std::memory_order::relaxed) + 1, std::memory_order::release);
+        }
+
+        std::chrono::steady_clock::duration smoothed_rtt() const {
+            return std::chrono::steady_clock::duration{smoothed.load(std::memory_order::relaxed)};
+        }
+        std::chrono::steady_clock::duration rtt_variance() const {
+            return std::chrono::steady_clock::duration{variance.load(std::memory_order::relaxed)};
+        }
+
+        static std::chrono::steady_clock::duration retransmission_timeout(
+            std::chrono::steady_clock::duration smoothed_rtt,
+            std::chrono::steady_clock::duration rtt_variance) {
+            return smoothed_rtt + std::max(granularity, 4 * rtt_variance);
+        }
+    };
+
+    // Written by the tick thread only; read from any thread.
+    struct Statistics {
+        std::atomic<uint64_t> read_requests = 0;
+        std::atomic<uint64_t> read_back_requests = 0;
+        std::atomic<uint64_t> write_requests = 0;
+
+        std::atomic<uint64_t> completed_reads = 0;
+        std::atomic<uint64_t> completed_confirmed_writes = 0;
+        std::atomic<uint64_t> completed_unconfirmed_writes = 0;
+        std::atomic<uint64_t> timed_out_operations = 0;
+        std::atomic<uint64_t> failed_operations = 0;
+
+        static void increase(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+        }
+    };
+
+    // Bytes handed to libusb per frame type, padding and CRC included.
+    struct Traffic {
+        std::atomic<uint64_t> sdo_bytes = 0;
+        std::atomic<uint64_t> pdo_bytes = 0;
+        std::atomic<uint64_t> sdo_bytes_per_second = 0; // Over the last second
+        std::atomic<uint64_t> pdo_bytes_per_second = 0;
+        std::atomic<uint64_t> deferred_sdo_requests = 0;
+
+        // Tick thread only.
+        std::chrono::steady_clock::time_point window_begin;
+        uint64_t window_sdo_bytes = 0;
+        uint64_t window_pdo_bytes = 0;
+    };
+
+    // Set up by `subscribe`; afterwards the tick thread advances `next_point` (steady clock ticks
+    // since epoch) each time it schedules a read.
+    struct Subscription {
+        std::atomic<std::chrono::steady_clock::duration::rep> period{0};
+        std::atomic<std::chrono::steady_clock::duration::rep> next_point{0};
+    };
+
+    // Aggregates the per-unit completions of a bulk operation into a single callback.
+    // Only touched by the tick thread once the member operations are published.
+    struct BulkOperation {
+        uint32_t index;
+        bool failed;
+        uint32_t error_code; // The first SDO error code reported by a member operation
+        size_t remaining;
+        TransactionItem* items; // Receives the result of each member operation, if not null
+
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code);
+        Buffer8 callback_context;
+    };
+
+    // Callback context of a member operation of a bulk operation.
+    struct BulkMember {
+        uint32_t bulk_index;
+        uint32_t item_index;
+    };
+
+    struct BulkMemberInfo {
+        int storage_id;
+        Operation::Mode mode;
+        Buffer8 raw_data; // Unused for reads
+    };
+
+    // Raw operations are dispatched by the tick thread as raw units become free, so a batch may
+    // be far larger than the number of raw units.
+    struct RawBatch {
+        RawItem* items;
+        size_t count;
+        size_t next; // The first item not dispatched yet
+        size_t remaining;
+        bool failed;
+        uint32_t error_code; // The first SDO error code reported by an item
+        std::chrono::steady_clock::duration::rep timeout;
+
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code);
+        Buffer8 callback_context;
+    };
+
+    // Callback context of a raw operation.
+    struct RawMember {
+        uint32_t unit; // Index among the raw units
+        uint32_t item_index;
+    };
+
+    // An operation submitted while its storage unit was busy. The tick thread starts queued
+    // operations in submission order as the unit becomes idle.
+    struct QueuedOperation {
+        Operation::Mode mode;
+        Buffer8 data; // Raw value to write, unused for reads
+        std::chrono::steady_clock::duration::rep timeout;
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code);
+        Buffer8 callback_context;
+        uint32_t write_epoch; // Of the unit when submitted, see `write_epochs_`
+    };
+
+    static constexpr size_t bulk_operation_count(size_t storage_unit_count) {
+        // Every pending bulk operation holds at least one storage unit or queue slot, and the
+        // extra slot covers a callback that starts a new bulk operation from the recycled one.
+        return storage_unit_count * (operation_queue_capacity + 1) + 1;
+    }
+
+    // Marks member operations of bulk operations, which `deliver_completion` passes to
+    // `complete_bulk_member` instead of calling this.
+    static void bulk_operation_callback(Buffer8, bool, uint32_t) {
+        throw std::logic_error("Bulk member operations must complete through the handler.");
+    }
+
+    void complete_bulk_member(BulkMember member, bool success, uint32_t error_code) {
+        auto& bulk = bulk_operations_[member.bulk_index];
+        if (bulk.items) {
+            auto& item = bulk.items[member.item_index];
+            item.success = success;
+            item.error_code = error_code;
+            // The unit completes before it starts its next operation, so this is the value read.
+            if (success && !item.write)
+                item.data = storage_[item.storage_id].value.load(std::memory_order::relaxed);
+        }
+
+        if (!success)
+            bulk.failed = true;
+        if (!bulk.error_code)
+            bulk.error_code = error_code;
+        if (--bulk.remaining)
             return;
-        if (operation_thread_id_ != std::this_thread::get_id()) [[unlikely]]
-            throw std::runtime_error(
-                "Thread safety violation: \n"
-                "  Operation must be called from the construction thread by default. \n"
-                "  If you want to perform operations in multiple threads, call:\n"
-                "      disable_thread_safe_check();\n"
-                "  And use mutex to ensure that ONLY ONE THREAD is operating at the same time.");
+
+        // Recycle the slot before invoking the callback, which may start a new bulk operation.
+        auto callback = bulk.callback;
+        auto callback_context = bulk.callback_context;
+        success = !bulk.failed;
+        error_code = bulk.error_code;
+        free_bulk_operations_.push_back(bulk.index);
+
+        deliver_completion(callback, callback_context, success, error_code);
     }
 
-    static void store_data(StorageUnit& storage, Buffer8 data) {
-        if (storage.info.policy & StorageInfo::CONTROL_WORD) {
-            storage.value.store(
-                Buffer8{static_cast<uint16_t>(data.as<bool>() ? 1 : 5)},
+    // Marks raw operations, which `deliver_completion` passes to `complete_raw_member`.
+    static void raw_operation_callback(Buffer8, bool, uint32_t) {
+        throw std::logic_error("Raw operations must complete through the handler.");
+    }
+
+    // Tick thread only.
+    void dispatch_raw_operations() {
+        while (submitted_raw_batches_.pop_front([this](std::unique_ptr<RawBatch>&& batch) {
+            raw_batches_.push_back(std::move(batch));
+        }))
+            ;
+
+        for (auto& batch : raw_batches_) {
+            while (batch->next < batch->count && !free_raw_units_.empty()) {
+                auto unit = free_raw_units_.back();
+                free_raw_units_.pop_back();
+                start_raw_operation(*batch, batch->next++, unit);
+            }
+            if (free_raw_units_.empty())
+                break;
+        }
+    }
+
+    void start_raw_operation(RawBatch& batch, size_t item_index, uint32_t unit) {
+        const auto& item = batch.items[item_index];
+        auto& storage = storage_[first_raw_unit_ + unit];
+        storage.info = StorageInfo{size_t{1} << int(item.size), item.index, item.sub_index};
+
+        auto mode = item.write ? write_mode(storage, item.confirmation) : Operation::Mode::READ;
+        try_claim(storage, mode); // Raw units are never claimed by anybody else
+        raw_unit_batches_[unit] = &batch;
+        raw_unit_keys_[unit].store(
+            raw_object_key(item.index, item.sub_index), std::memory_order::release);
+        start_operation(
+            storage, mode, item.data, batch.timeout, raw_operation_callback,
+            Buffer8{RawMember{unit, static_cast<uint32_t>(item_index)}});
+    }
+
+    void complete_raw_member(RawMember member, bool success, uint32_t error_code) {
+        auto& batch = *raw_unit_batches_[member.unit];
+        auto& item = batch.items[member.item_index];
+        item.success = success;
+        item.error_code = error_code;
+        if (success && !item.write)
+            item.data = storage_[first_raw_unit_ + member.unit].value.load(
                 std::memory_order::relaxed);
-        } else if (storage.info.policy & StorageInfo::POSITION) {
-            auto value = to_raw_position(data.as<double>());
-            if (storage.info.policy & StorageInfo::POSITION_REVERSED)
-                value = -value;
-            storage.value.store(Buffer8{value}, std::memory_order::relaxed);
-        } else
-            storage.value.store(data, std::memory_order::relaxed);
+
+        raw_unit_keys_[member.unit].store(0, std::memory_order::relaxed);
+        raw_unit_batches_[member.unit] = nullptr;
+        free_raw_units_.push_back(member.unit);
+
+        if (!success)
+            batch.failed = true;
+        if (!batch.error_code)
+            batch.error_code = error_code;
+        if (--batch.remaining)
+            return;
+
+        auto callback = batch.callback;
+        auto callback_context = batch.callback_context;
+        success = !batch.failed;
+        error_code = batch.error_code;
+        std::erase_if(raw_batches_, [&batch](const auto& other) { return other.get() == &batch; });
+
+        deliver_completion(callback, callback_context, success, error_code);
     }
 
-    static Buffer8 load_data(StorageUnit& storage) {
-        Buffer8 data = storage.value.load(std::memory_order::relaxed);
+    // Submits `count` member operations, described by `member(i)`, that complete together.
+    template <typename Member>
+    void submit_bulk(
+        size_t count, const Member& member, TransactionItem* items,
+        std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        if (!count) [[unlikely]] {
+            // There is no tick thread to deliver from, and only it may feed the completion queue.
+            if (callback == &Handler::queue_completion)
+                throw std::invalid_argument("Cannot queue the completion of an empty operation.");
+            callback(callback_context, true, 0);
+            return;
+        }
 
-        if (storage.info.policy & StorageInfo::CONTROL_WORD) {
-            return Buffer8{data.as<uint16_t>() == 1};
-        } else if (storage.info.policy & StorageInfo::POSITION) {
-            auto value = extract_raw_position(data.as<int32_t>());
-            if (storage.info.policy & StorageInfo::POSITION_REVERSED)
-                value = -value;
-            return Buffer8{value};
+        // Reserve queue room for every member first, so that the submissions below cannot fail
+        // halfway even while other threads submit too. A unit may appear more than once.
+        auto release_queues = [this, &member](size_t reserved) {
+            for (size_t i = 0; i < reserved; i++)
+                operation_queues_[member(i).storage_id].release();
+        };
+        for (size_t i = 0; i < count; i++) {
+            if (!operation_queues_[member(i).storage_id].reserve()) [[unlikely]] {
+                release_queues(i);
+                throw std::runtime_error("Illegal checked operation: Operation queue is full!");
+            }
         }
 
-        return data;
+        if (!reserve_completion(callback)) [[unlikely]] {
+            release_queues(count);
+            throw std::runtime_error("Completion queue is full: drain it with poll_completions!");
+        }
+        uint32_t bulk_index;
+        if (!free_bulk_operations_.pop_front([&bulk_index](uint32_t i) { bulk_index = i; })) {
+            cancel_completion(callback);
+            release_queues(count);
+            throw std::runtime_error("No bulk operation slot available!");
+        }
+
+        auto& bulk = bulk_operations_[bulk_index];
+        bulk.remaining = count;
+        bulk.failed = false;
+        bulk.error_code = 0;
+        bulk.items = items;
+        bulk.callback = callback;
+        bulk.callback_context = callback_context;
+
+        for (size_t i = 0; i < count; i++) {
+            auto info = member(i);
+            submit_reserved(
+                info.storage_id, info.mode, info.raw_data, timeout, bulk_operation_callback,
+                Buffer8{BulkMember{bulk_index, static_cast<uint32_t>(i)}});
+        }
+        // Once for all members, so that they still leave in the same frames.
+        wake_tick_thread();
+    }
+
+    // Operations completing into the completion queue reserve their entry on submission, so
+    // that the tick thread can never find the queue full.
+    bool reserve_completion(void (*callback)(Buffer8 context, bool success, uint32_t error_code)) {
+        if (callback != &Handler::queue_completion)
+            return true;
+        if (completion_reservations_.fetch_add(1, std::memory_order::relaxed)
+            >= completion_queue_capacity) {
+            completion_reservations_.fetch_sub(1, std::memory_order::relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void cancel_completion(void (*callback)(Buffer8 context, bool success, uint32_t error_code)) {
+        if (callback == &Handler::queue_completion)
+            completion_reservations_.fetch_sub(1, std::memory_order::relaxed);
+    }
+
+    // Tick thread only.
+    void deliver_completion(
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code), Buffer8 context,
+        bool success, uint32_t error_code) {
+        if (callback == &bulk_operation_callback) {
+            complete_bulk_member(context.as<BulkMember>(), success, error_code);
+        } else if (callback == &raw_operation_callback) {
+            complete_raw_member(context.as<RawMember>(), success, error_code);
+        } else if (callback == &Handler::queue_completion) {
+            completion_queue_.emplace_back(context.as<uint64_t>(), success, error_code);
+            completion_event_.notify_all();
+        } else if (callback) {
+            callback(context, success, error_code);
+        }
+    }
+
+    // Subscriptions are scheduled from the tick thread, so every issuer must take ownership of an
+    // idle storage unit atomically before touching its non-atomic fields.
+    static bool try_claim(StorageUnit& storage, Operation::Mode mode) {
+        auto expected = storage.operation.load(std::memory_order::relaxed);
+        if (expected.mode != Operation::Mode::NONE)
+            return false;
+        return storage.operation.compare_exchange_strong(
+            expected, expected.claimed(mode), std::memory_order::acquire,
+            std::memory_order::relaxed);
+    }
+
+    // Hands a unit claimed by `try_claim` to the tick thread.
+    static void publish(StorageUnit& storage) {
+        auto operation = storage.operation.load(std::memory_order::relaxed);
+        operation.state = Operation::State::WAITING;
+        storage.operation.store(operation, std::memory_order::release);
+    }
+
+    static Operation::Mode write_mode(const StorageUnit& storage, WriteConfirmation confirmation) {
+        bool confirmed = confirmation == WriteConfirmation::DEFAULT
+                           ? storage.confirm_writes.load(std::memory_order::relaxed)
+                           : confirmation == WriteConfirmation::CONFIRMED;
+        return confirmed ? Operation::Mode::WRITE : Operation::Mode::WRITE_UNCONFIRMED;
+    }
+
+    // Returns whether the tick thread has new work. Dropped if the queue is full.
+    bool submit_unchecked_read(int storage_id, std::chrono::steady_clock::duration::rep timeout) {
+        // A pending read refreshes the value anyway.
+        if (storage_[storage_id].operation.load(std::memory_order::relaxed).mode
+                == Operation::Mode::READ
+            && !operation_queues_[storage_id].readable())
+            return false;
+
+        return submit(storage_id, Operation::Mode::READ, Buffer8{}, timeout, nullptr, Buffer8{});
+    }
+
+    // Returns whether the tick thread has new work. Dropped if the queue is full.
+    bool submit_unchecked_write(
+        Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
+        WriteConfirmation confirmation) {
+        auto& storage = storage_[storage_id];
+
+        // Supersede a pending write instead of queueing behind it: every (re)transmission sends
+        // the latest value, and a read-back only confirms the latest value.
+        if (!operation_queues_[storage_id].readable()) {
+            auto operation = storage.operation.load(std::memory_order::acquire);
+            if (operation.can_be_superseded()) {
+                storage.value.store(data, std::memory_order::relaxed);
+                // A confirmed write that was already sent goes back to WRITING, so that the
+                // new value is sent on the next tick. If the operation moved on in between, the
+                // new value may never be sent, so it is queued after all.
+                if (storage.operation.compare_exchange_strong(
+                        operation, operation.superseded(), std::memory_order::acq_rel))
+                    return false;
+            }
+        }
+
+        return submit(
+            storage_id, write_mode(storage, confirmation), data, timeout, nullptr, Buffer8{});
+    }
+
+    // Starts the operation at once if the storage unit is idle, otherwise appends it to the
+    // unit's queue. Returns false if the queue is full. Any thread may submit; operations on one
+    // unit run in the order their submissions were made.
+    bool submit(
+        int storage_id, Operation::Mode mode, Buffer8 raw_data,
+        std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        if (!operation_queues_[storage_id].reserve())
+            return false;
+        submit_reserved(storage_id, mode, raw_data, timeout, callback, callback_context);
+        return true;
+    }
+
+    // As `submit`, into queue room already reserved.
+    void submit_reserved(
+        int storage_id, Operation::Mode mode, Buffer8 raw_data,
+        std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        auto& storage = storage_[storage_id];
+        auto& queue = operation_queues_[storage_id];
+
+        // Never overtake operations that are already queued, or still being queued.
+        if (!queue.readable() && try_claim(storage, mode)) {
+            queue.release();
+            start_operation(storage, mode, raw_data, timeout, callback, callback_context);
+            return;
+        }
+        queue.emplace_reserved(
+            mode, raw_data, timeout, callback, callback_context,
+            write_epochs_[storage_id].load(std::memory_order::relaxed));
+    }
+
+    // Tick thread only.
+    bool start_queued_operation(size_t storage_id) {
+        auto& storage = storage_[storage_id];
+        auto& queue = operation_queues_[storage_id];
+        while (auto queued = queue.front()) {
+            // Dropped by a later `write_immediately`, which the write must not undo.
+            if (queued->mode != Operation::Mode::READ
+                && queued->write_epoch
+                       != write_epochs_[storage_id].load(std::memory_order::relaxed)) {
+                auto callback = queued->callback;
+                auto context = queued->callback_context;
+                queue.pop_front([](QueuedOperation&&) {});
+                Statistics::increase(statistics_.failed_operations);
+                deliver_completion(callback, context, false, 0);
+                continue;
+            }
+            if (!try_claim(storage, queued->mode))
+                return false;
+
+            start_operation(
+                storage, queued->mode, queued->data, queued->timeout, queued->callback,
+                queued->callback_context);
+            queue.pop_front([](QueuedOperation&&) {});
+            return true;
+        }
+        return false;
+    }
+
+    // Fills in a claimed storage unit and hands it to the tick thread.
+    static void start_operation(
+        StorageUnit& storage, Operation::Mode mode, Buffer8 raw_data,
+        std::chrono::steady_clock::duration::rep timeout,
+        void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+        Buffer8 callback_context) {
+        if (mode != Operation::Mode::READ)
+            storage.value.store(raw_data, std::memory_order::relaxed);
+        storage.timeout = std::chrono::steady_clock::duration(timeout);
+        storage.callback = callback;
+        storage.callback_context = callback_context;
+        publish(storage);
+    }
+
+    // Tick thread only. Fails if another thread moved the `observed` operation on, in which
+    // case the unit is looked at again on the next tick.
+    bool complete_operation(
+        StorageUnit& storage, Operation observed, bool success, uint32_t error_code) {
+        auto callback = storage.callback;
+        auto context = storage.callback_context;
+        auto completed = observed;
+        completed.mode = Operation::Mode::NONE;
+        if (!storage.operation.compare_exchange_strong(
+                observed, completed, std::memory_order::release, std::memory_order::relaxed))
+            return false;
+        deliver_completion(callback, context, success, error_code);
+        return true;
     }
 
     static int32_t to_raw_position(double angle) {
@@ -287,7 +1116,7 @@ private:
         return buffer;
     }
 
-    static void before_submitting_transmit_transfer(libusb_transfer* transfer) {
+    void before_submitting_transmit_transfer(libusb_transfer* transfer) {
         auto compressed_frame_length = static_cast<uint16_t>(
             (transfer->length + (int)sizeof(protocol::CrcCheck) - 1) / 16 + 1);
         auto padded_length = 16 * compressed_frame_length;
@@ -301,6 +1130,13 @@ private:
         } description{
             .max_receive_window = 0xA0, .frame_length = (uint8_t)(compressed_frame_length - 1)};
         header.description = std::bit_cast<int16_t>(description);
+
+        (header.type == 0x11 ? traffic_.pdo_bytes : traffic_.sdo_bytes)
+            .fetch_add(padded_length, std::memory_order::relaxed);
+
+        // Under `emergency_mutex_`, see `write_immediately`.
+        if (transfer->user_data == &emergency_transmit_buffer_)
+            emergency_submitted_.fetch_add(1, std::memory_order::relaxed);
     }
 
     void transmit_transfer_completed_callback(libusb_transfer* transfer) {
@@ -313,6 +1149,14 @@ private:
 
         auto& header = *reinterpret_cast<protocol::Header*>(transfer->buffer);
         header.type = 0;
+
+        if (transfer->user_data == &emergency_transmit_buffer_) {
+            emergency_transmit_point_.store(
+                std::chrono::steady_clock::now().time_since_epoch().count(),
+                std::memory_order::relaxed);
+            emergency_transmitted_.fetch_add(1, std::memory_order::release);
+            emergency_event_.notify_all();
+        }
     }
 
     void receive_transfer_completed_callback(libusb_transfer* transfer) {
@@ -326,6 +1170,15 @@ private:
         auto pointer = reinterpret_cast<std::byte*>(transfer->buffer);
         const auto sentinel = pointer + transfer->actual_length;
 
+        // Seqlock write side, so that `get_consistent` never sees half of a frame's values. Only
+        // the event thread receives.
+        auto sequence = receive_sequence_.load(std::memory_order::relaxed);
+        receive_sequence_.store(sequence + 1, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::release);
+        utility::FinalAction end_of_pass{[this, sequence]() {
+            receive_sequence_.store(sequence + 2, std::memory_order::release);
+        }};
+
         try {
             const auto& header =
                 read_frame_struct<protocol::Header>(pointer, sentinel, "Frame header");
@@ -371,70 +1224,186 @@ private:
         }
     }
 
+    // Stores a value that is now known to be the device's, and bumps its version.
+    void publish_value(
+        StorageUnit& storage, Buffer8 value, std::chrono::steady_clock::time_point now) {
+        storage.value.store(value, std::memory_order::relaxed);
+        update_points_[&storage - storage_.get()].store(
+            now.time_since_epoch().count(), std::memory_order::release);
+        auto new_version = storage.version.load(std::memory_order::relaxed) + 1;
+        if (new_version == 0)
+            new_version = 1;
+        storage.version.store(new_version, std::memory_order::release);
+        update_event_.notify_all();
+    }
+
     template <typename T>
     void read_sdo_operation_read_success(std::byte*& pointer, const std::byte* sentinel) {
         const auto& data = read_frame_struct<protocol::sdo::ReadResultSuccess<T>>(
             pointer, sentinel, "SDO read success frame");
 
-        StorageUnit& storage = find_storage_by_index(data.header.index, data.header.sub_index);
-
-        auto operation = storage.operation.load(std::memory_order::acquire);
-        if (operation.mode == Operation::Mode::NONE) [[unlikely]]
+        Operation operation;
+        auto pending = find_pending_storage(data.header.index, data.header.sub_index, operation);
+        if (!pending) [[unlikely]]
             return;
+        StorageUnit& storage = *pending;
 
+        // Every transition is made from the operation observed with the response, which is
+        // dropped if the operation timed out or was superseded in between.
         if (operation.state == Operation::State::READING) {
-            storage.value.store(Buffer8{data.value}, std::memory_order::relaxed);
-            auto new_version = storage.version.load(std::memory_order::relaxed) + 1;
-            if (new_version == 0)
-                new_version = 1;
-            storage.version.store(new_version, std::memory_order::release);
+            // Owning the unit keeps the tick thread from completing or reusing it while the
+            // value is published.
+            if (!Operation::transition(
+                    storage.operation, operation, Operation::State::RESPONDING))
+                return;
+            auto now = std::chrono::steady_clock::now();
+            sample_round_trip(storage, now);
+            publish_value(storage, Buffer8{data.value}, now);
 
             operation.state = Operation::State::SUCCESS;
             storage.operation.store(operation, std::memory_order::release);
         } else if (operation.state == Operation::State::WRITING_CONFIRMING) {
-            if (data.value == storage.value.load(std::memory_order::relaxed).as<T>()) {
-                operation.state = Operation::State::SUCCESS;
-                storage.operation.store(operation, std::memory_order::relaxed);
-            } else {
-                operation.state = Operation::State::WRITING;
-                storage.operation.store(operation, std::memory_order::relaxed);
-            }
+            bool confirmed =
+                data.value == storage.value.load(std::memory_order::relaxed).as<T>();
+            if (Operation::transition(
+                    storage.operation, operation,
+                    confirmed ? Operation::State::SUCCESS : Operation::State::WRITING))
+                sample_round_trip(storage, std::chrono::steady_clock::now());
         }
     }
 
-    static void read_sdo_operation_read_failed(std::byte*& pointer, const std::byte* sentinel) {
-        read_frame_struct<protocol::sdo::ReadResultError>(
+    void read_sdo_operation_read_failed(std::byte*& pointer, const std::byte* sentinel) {
+        const auto& data = read_frame_struct<protocol::sdo::ReadResultError>(
             pointer, sentinel, "SDO read failure frame");
+
+        Operation operation;
+        auto pending = find_pending_storage(data.header.index, data.header.sub_index, operation);
+        if (!pending) [[unlikely]]
+            return;
+        StorageUnit& storage = *pending;
+
+        // A rejected read-back fails the write it confirms.
+        if (operation.state == Operation::State::READING
+            || operation.state == Operation::State::WRITING_CONFIRMING)
+            fail_sdo_operation(storage, operation, data.err_code);
     }
 
     void read_sdo_operation_write_success(std::byte*& pointer, const std::byte* sentinel) {
         const auto& data = read_frame_struct<protocol::sdo::WriteResultSuccess>(
             pointer, sentinel, "SDO write success frame");
 
-        StorageUnit& storage = find_storage_by_index(data.header.index, data.header.sub_index);
+        Operation operation;
+        auto pending = find_pending_storage(data.header.index, data.header.sub_index, operation);
+        if (!pending) [[unlikely]]
+            return;
+        StorageUnit& storage = *pending;
+
+        // Confirmed writes only complete on their read-back: after a superseding write, this
+        // acknowledgement may be for the old value.
+        if (operation.state == Operation::State::WRITING
+            && operation.mode == Operation::Mode::WRITE_UNCONFIRMED
+            && Operation::transition(storage.operation, operation, Operation::State::SUCCESS))
+            sample_round_trip(storage, std::chrono::steady_clock::now());
+    }
 
-        auto operation = storage.operation.load(std::memory_order::acquire);
-        if (operation.mode == Operation::Mode::NONE) [[unlikely]]
+    void sample_round_trip(StorageUnit& storage, std::chrono::steady_clock::time_point now) {
+        auto dispatch_point = storage.dispatch_point.exchange(0, std::memory_order::relaxed);
+        if (!dispatch_point)
             return;
+        rtt_.update(now.time_since_epoch() - std::chrono::steady_clock::duration{dispatch_point});
+    }
 
-        if (operation.state == Operation::State::WRITING) {
-            operation.state = Operation::State::SUCCESS;
-            storage.operation.store(operation, std::memory_order::relaxed);
-        }
+    // Time before an unanswered request is resent for the first time, doubled on every further
+    // resend. As in Karn's algorithm, a backed-off interval is kept for later requests until a
+    // response yields a new sample, so that a grown round-trip time can still be measured.
+    std::chrono::steady_clock::duration initial_retransmission_interval(
+        std::chrono::steady_clock::duration update_period) {
+        auto samples = rtt_.samples.load(std::memory_order::acquire);
+        if (samples != backoff_samples_)
+            retransmission_backoff_ = std::chrono::steady_clock::duration::zero();
+        auto interval = samples ? RttEstimator::retransmission_timeout(
+                                      rtt_.smoothed_rtt(), rtt_.rtt_variance())
+                                : unsampled_retransmission_interval;
+        return std::clamp(
+            std::max(interval, retransmission_backoff_), update_period,
+            max_retransmission_interval);
     }
 
-    static void read_sdo_operation_write_failed(std::byte*& pointer, const std::byte* sentinel) {
-        read_frame_struct<protocol::sdo::WriteResultError>(
+    std::chrono::steady_clock::duration adaptive_operation_timeout(Operation::Mode mode) const {
+        if (!rtt_.samples.load(std::memory_order::acquire))
+            return adaptive_timeout_max;
+
+        auto timeout = adaptive_timeout_rto_multiplier
+                     * RttEstimator::retransmission_timeout(
+                           rtt_.smoothed_rtt(), rtt_.rtt_variance());
+        // A confirmed write needs a second round trip for the read-back.
+        if (mode == Operation::Mode::WRITE)
+            timeout *= 2;
+        return std::clamp(timeout, adaptive_timeout_min, adaptive_timeout_max);
+    }
+
+    void read_sdo_operation_write_failed(std::byte*& pointer, const std::byte* sentinel) {
+        const auto& data = read_frame_struct<protocol::sdo::WriteResultError>(
             pointer, sentinel, "SDO write failure frame");
+
+        Operation operation;
+        auto pending = find_pending_storage(data.header.index, data.header.sub_index, operation);
+        if (!pending) [[unlikely]]
+            return;
+        StorageUnit& storage = *pending;
+
+        // The tick thread moves confirmed writes on to WRITING_CONFIRMING as soon as the write
+        // is sent, so the response to it usually arrives in that state.
+        if (operation.state == Operation::State::WRITING
+            || operation.state == Operation::State::WRITING_CONFIRMING)
+            fail_sdo_operation(storage, operation, data.err_code);
     }
 
-    StorageUnit& find_storage_by_index(uint16_t index, uint8_t sub_index) {
+    void fail_sdo_operation(StorageUnit& storage, Operation operation, uint32_t error_code) {
+        logger_.debug(
+            "SDO error response: index=0x{:04X}, sub-index=0x{:02X}, err_code=0x{:08X}",
+            storage.info.index, storage.info.sub_index, error_code);
+
+        // Only this thread writes the error code, and the tick thread only reads it once the
+        // operation is FAILED, so it is safe to write before the transition may be dropped.
+        storage.error_code = error_code;
+        Operation::transition(storage.operation, operation, Operation::State::FAILED);
+    }
+
+    // Finds the storage unit whose operation awaits this response, or null if there is none.
+    // Raw operations take precedence; an operation on the same registered object keeps
+    // retransmitting until it gets its own response.
+    StorageUnit* find_pending_storage(uint16_t index, uint8_t sub_index, Operation& operation) {
+        auto key = raw_object_key(index, sub_index);
+        for (size_t i = 0; i < raw_unit_count; i++) {
+            if (raw_unit_keys_[i].load(std::memory_order::acquire) != key)
+                continue;
+            auto& storage = storage_[first_raw_unit_ + i];
+            operation = storage.operation.load(std::memory_order::acquire);
+            // Check the key again: the unit may have been reassigned in between.
+            if (operation.mode != Operation::Mode::NONE
+                && raw_unit_keys_[i].load(std::memory_order::relaxed) == key)
+                return &storage;
+        }
+
         auto it = index_storage_map_.find(
             std::bit_cast<uint32_t>(IndexMapKey{.index = index, .sub_index = sub_index}));
-        if (it == index_storage_map_.end())
-            throw std::runtime_error{std::format(
-                "SDO object not found: index=0x{:04X}, sub-index=0x{:02X}", index, sub_index)};
-        return *it->second;
+        if (it == index_storage_map_.end()) {
+            // Typically a late answer to a raw operation that has already completed.
+            logger_.debug(
+                "Ignoring SDO response of unknown object: index=0x{:04X}, sub-index=0x{:02X}",
+                index, sub_index);
+            return nullptr;
+        }
+
+        operation = it->second->operation.load(std::memory_order::acquire);
+        if (operation.mode == Operation::Mode::NONE)
+            return nullptr;
+        return it->second;
+    }
+
+    static constexpr uint32_t raw_object_key(uint16_t index, uint8_t sub_index) {
+        return 1u << 24 | uint32_t{index} << 8 | sub_index; // Never 0, which marks an idle unit
     }
 
     void tick_thread_main(const std::stop_token& token) {
@@ -443,28 +1412,109 @@ private:
             std::chrono::duration_cast<std::chrono::steady_clock::duration>(
                 std::chrono::duration<double>(1.0 / update_rate));
 
+        traffic_.window_begin = std::chrono::steady_clock::now();
+        size_t first_unit = 0;
+        auto last_transmit_point = traffic_.window_begin;
+        std::stop_callback wake_on_stop{token, [this]() { wake_tick_thread(); }};
+
         while (!token.stop_requested()) {
+            // Read before scanning: a submission after this point always ends an idle wait.
+            auto seen_submissions = submissions_.load(std::memory_order::acquire);
             auto now = std::chrono::steady_clock::now();
-
-            for (size_t i = 0; i < storage_unit_count_; i++) {
+            bool idle = true;
+            auto next_subscription_point = std::chrono::steady_clock::time_point::max();
+            update_traffic_rates(now);
+            refill_sdo_budget(now, update_period);
+            dispatch_raw_operations();
+
+            // Rotate the first unit served, so that a tight SDO budget is shared fairly.
+            if (++first_unit >= storage_unit_count_)
+                first_unit = 0;
+            for (size_t k = 0; k < storage_unit_count_; k++) {
+                size_t i = first_unit + k;
+                if (i >= storage_unit_count_)
+                    i -= storage_unit_count_;
                 auto& storage = storage_[i];
+                auto& queue = operation_queues_[i];
+                bool masked = storage.info.policy & Handler::StorageInfo::MASKED;
 
                 auto operation = storage.operation.load(std::memory_order::acquire);
-                if (operation.mode == Operation::Mode::NONE)
+                if (operation.mode == Operation::Mode::NONE) {
+                    // Queued user operations take precedence over subscription reads.
+                    if (!start_queued_operation(i)) {
+                        auto& subscription = subscriptions_[i];
+                        auto period = subscription.period.load(std::memory_order::acquire);
+                        // Background reads yield to the PDO lane once the budget is spent.
+                        if (period && sdo_budget_ >= sizeof(protocol::sdo::Read))
+                            schedule_subscription_read(storage, subscription, period, now);
+                        if (period)
+                            next_subscription_point = std::min(
+                                next_subscription_point,
+                                std::chrono::steady_clock::time_point{
+                                    std::chrono::steady_clock::duration{
+                                        subscription.next_point.load(
+                                            std::memory_order::relaxed)}});
+                    }
+                    operation = storage.operation.load(std::memory_order::acquire);
+                }
+                if (operation.mode == Operation::Mode::NONE
+                    || operation.state == Operation::State::PREPARING)
                     continue;
 
-                if (storage.info.policy & Handler::StorageInfo::MASKED)
+                // The receive thread completes it shortly.
+                if (operation.state == Operation::State::RESPONDING) {
+                    idle = false;
+                    continue;
+                }
+
+                if (masked) {
+                    // Never sent, so nothing else moves it on but a superseding value.
+                    if (!complete_operation(storage, operation, true, 0)) {
+                        idle = false;
+                        continue;
+                    }
                     operation.state = Operation::State::SUCCESS;
-                if (operation.state == Operation::State::SUCCESS) {
-                    auto callback = storage.callback;
-                    auto context = storage.callback_context;
-                    operation.mode = Operation::Mode::NONE;
-                    storage.operation.store(operation, std::memory_order::release);
-                    if (callback)
-                        callback(context, true);
                 }
+                if (operation.state == Operation::State::SUCCESS
+                    || operation.state == Operation::State::FAILED
+                    || operation.state == Operation::State::CANCELLED) {
+                    if (operation.state == Operation::State::FAILED) {
+                        Statistics::increase(statistics_.failed_operations);
+                        complete_operation(storage, operation, false, storage.error_code);
+                    } else if (operation.state == Operation::State::CANCELLED) {
+                        Statistics::increase(statistics_.failed_operations);
+                        complete_operation(storage, operation, false, 0);
+                    } else if (!masked) {
+                        Statistics::increase(
+                            operation.mode == Operation::Mode::READ
+                                ? statistics_.completed_reads
+                                : (operation.mode == Operation::Mode::WRITE
+                                       ? statistics_.completed_confirmed_writes
+                                       : statistics_.completed_unconfirmed_writes));
+                        complete_operation(storage, operation, true, 0);
+                    }
 
+                    // Start the next queued operation without waiting for another tick.
+                    if (masked || !start_queued_operation(i)) {
+                        if (queue.readable())
+                            idle = false; // Masked units start it next tick
+                        continue;
+                    }
+                    operation = storage.operation.load(std::memory_order::acquire);
+                }
+
+                idle = false;
+                bool first_send = false;
                 if (operation.state == Operation::State::WAITING) {
+                    // Deferred by the SDO budget: the timeout only starts once dispatched.
+                    if (!consume_sdo_budget(
+                            storage, operation.mode == Operation::Mode::READ
+                                         ? Operation::State::READING
+                                         : Operation::State::WRITING))
+                        continue;
+
+                    if (storage.timeout.count() == adaptive_timeout)
+                        storage.timeout = adaptive_operation_timeout(operation.mode);
                     if (storage.timeout < std::chrono::steady_clock::duration::zero()
                         || now > std::chrono::steady_clock::time_point::max() - storage.timeout)
                         // Treat negative or overflowed timeout as never expires
@@ -472,54 +1522,211 @@ private:
                     else
                         storage.timeout_point = now + storage.timeout;
 
+                    // Dispatch in the same tick, so that a bulk operation submitted at once
+                    // leaves in the same frames and costs a single round trip.
                     operation.state =
                         (operation.mode == Operation::Mode::READ ? Operation::State::READING
                                                                  : Operation::State::WRITING);
                     storage.operation.store(operation, std::memory_order::relaxed);
-                } else if (now >= storage.timeout_point) {
-                    auto callback = storage.callback;
-                    auto context = storage.callback_context;
-                    operation.mode = Operation::Mode::NONE;
-                    storage.operation.store(operation, std::memory_order::release);
-                    if (callback)
-                        callback(context, false);
-                } else if (
-                    operation.state == Operation::State::READING
+                    first_send = true;
+                }
+
+                if (now >= storage.timeout_point) {
+                    // A response that arrived in between wins, and is completed next tick.
+                    if (complete_operation(storage, operation, false, 0))
+                        Statistics::increase(statistics_.timed_out_operations);
+                    continue;
+                }
+
+                // A request is new when the operation has moved on since the last send: the first
+                // read-back of a confirmed write, or a write repeated after a mismatching
+                // read-back or with a superseding value. Unanswered requests are resent with
+                // exponential backoff.
+                auto& retransmission = retransmissions_[i];
+                auto value = storage.value.load(std::memory_order::relaxed);
+                bool fresh = first_send || operation.state != retransmission.sent_state
+                          || (operation.state == Operation::State::WRITING
+                              && value.as<uint64_t>() != retransmission.sent_value);
+                if (!fresh && now < retransmission.next_point)
+                    continue;
+
+                // A send deferred by the SDO budget is simply retried next tick.
+                if (!first_send && !consume_sdo_budget(storage, operation.state))
+                    continue;
+
+                // A sent confirmed write awaits its read-back. If a superseding value or an
+                // error response moved it on in between, it is looked at again next tick.
+                if (operation.state == Operation::State::WRITING
+                    && operation.mode == Operation::Mode::WRITE
+                    && !Operation::transition(
+                        storage.operation, operation, Operation::State::WRITING_CONFIRMING,
+                        std::memory_order::relaxed))
+                    continue;
+
+                if (fresh) {
+                    storage.dispatch_point.store(
+                        now.time_since_epoch().count(), std::memory_order::relaxed);
+                    retransmission.interval = initial_retransmission_interval(update_period);
+                } else {
+                    storage.dispatch_point.store(0, std::memory_order::relaxed);
+                    retransmission.interval =
+                        std::min(2 * retransmission.interval, max_retransmission_interval);
+                    retransmission_backoff_ =
+                        std::max(retransmission_backoff_, retransmission.interval);
+                    backoff_samples_ = rtt_.samples.load(std::memory_order::acquire);
+                }
+                retransmission.next_point = now + retransmission.interval;
+                retransmission.sent_state = operation.state;
+                retransmission.sent_value = value.as<uint64_t>();
+
+                if (operation.state == Operation::State::READING
                     || operation.state == Operation::State::WRITING_CONFIRMING) {
+                    Statistics::increase(
+                        operation.state == Operation::State::READING
+                            ? statistics_.read_requests
+                            : statistics_.read_back_requests);
                     read_async_unchecked_internal(
                         tick_thread_transmit_buffer_, storage.info.index, storage.info.sub_index);
                 } else if (operation.state == Operation::State::WRITING) {
-                    operation.state = Operation::State::WRITING_CONFIRMING;
-                    storage.operation.store(operation, std::memory_order::relaxed);
+                    // Unconfirmed writes stay in WRITING, so the write is repeated until its
+                    // acknowledgement arrives.
+                    Statistics::increase(statistics_.write_requests);
                     if (storage.info.size == StorageInfo::Size::_1)
                         write_async_unchecked_internal(
-                            tick_thread_transmit_buffer_,
-                            storage.value.load(std::memory_order::relaxed).as<uint8_t>(),
-                            storage.info.index, storage.info.sub_index);
+                            tick_thread_transmit_buffer_, value.as<uint8_t>(), storage.info.index,
+                            storage.info.sub_index);
                     else if (storage.info.size == StorageInfo::Size::_2)
                         write_async_unchecked_internal(
-                            tick_thread_transmit_buffer_,
-                            storage.value.load(std::memory_order::relaxed).as<uint16_t>(),
-                            storage.info.index, storage.info.sub_index);
+                            tick_thread_transmit_buffer_, value.as<uint16_t>(), storage.info.index,
+                            storage.info.sub_index);
                     else if (storage.info.size == StorageInfo::Size::_4)
                         write_async_unchecked_internal(
-                            tick_thread_transmit_buffer_,
-                            storage.value.load(std::memory_order::relaxed).as<uint32_t>(),
-                            storage.info.index, storage.info.sub_index);
+                            tick_thread_transmit_buffer_, value.as<uint32_t>(), storage.info.index,
+                            storage.info.sub_index);
                     else if (storage.info.size == StorageInfo::Size::_8)
                         write_async_unchecked_internal(
-                            tick_thread_transmit_buffer_,
-                            storage.value.load(std::memory_order::relaxed).as<uint64_t>(),
-                            storage.info.index, storage.info.sub_index);
+                            tick_thread_transmit_buffer_, value.as<uint64_t>(), storage.info.index,
+                            storage.info.sub_index);
                 }
             }
-            fetch_sdo_buffer(tick_thread_transmit_buffer_, 0);
-            tick_thread_transmit_buffer_.trigger_transmission(true);
+            // Frames are only sent when there are requests, plus an optional empty heartbeat.
+            auto heartbeat_interval = std::chrono::steady_clock::duration{
+                heartbeat_interval_.load(std::memory_order::relaxed)};
+            if (tick_thread_transmit_buffer_.trigger_transmission())
+                last_transmit_point = now;
+            else if (
+                heartbeat_interval > std::chrono::steady_clock::duration::zero()
+                && now - last_transmit_point >= heartbeat_interval) {
+                fetch_sdo_buffer(tick_thread_transmit_buffer_, 0);
+                tick_thread_transmit_buffer_.trigger_transmission(true);
+                last_transmit_point = now;
+            }
+
+            if (!idle) {
+                std::this_thread::sleep_for(update_period);
+                continue;
+            }
 
-            std::this_thread::sleep_for(update_period);
+            // Nothing in flight: sleep until a submission, the next subscription read, the next
+            // heartbeat, or the next traffic rate update, but at least one tick period.
+            auto wake_point = std::min(next_subscription_point, now + std::chrono::seconds(1));
+            if (heartbeat_interval > std::chrono::steady_clock::duration::zero())
+                wake_point = std::min(wake_point, last_transmit_point + heartbeat_interval);
+            tick_event_.wait_until(
+                [&]() {
+                    return submissions_.load(std::memory_order::acquire) != seen_submissions
+                        || token.stop_requested();
+                },
+                std::max(wake_point - std::chrono::steady_clock::now(), update_period));
         }
     }
 
+    // Called after publishing work for the tick thread.
+    void wake_tick_thread() {
+        submissions_.fetch_add(1, std::memory_order::release);
+        tick_event_.notify_all();
+    }
+
+    // Token bucket limiting SDO requests while the PDO lane is active, so that background
+    // traffic cannot delay realtime frames. Unlimited otherwise.
+    void refill_sdo_budget(
+        std::chrono::steady_clock::time_point now, std::chrono::steady_clock::duration period) {
+        auto elapsed = now - last_refill_point_;
+        last_refill_point_ = now;
+
+        auto limit = sdo_bandwidth_limit_.load(std::memory_order::relaxed);
+        auto last_pdo_point = std::chrono::steady_clock::time_point{
+            std::chrono::steady_clock::duration{last_pdo_point_.load(std::memory_order::relaxed)}};
+        if (!limit || now - last_pdo_point > pdo_activity_window) {
+            sdo_budget_ = std::numeric_limits<double>::infinity();
+            return;
+        }
+
+        // Allow a burst of one tick, but always enough for the largest request.
+        auto burst = std::max(
+            limit * std::chrono::duration<double>(period).count(),
+            double(sizeof(protocol::sdo::Write<uint64_t>)));
+        sdo_budget_ = std::min(
+            sdo_budget_ + limit * std::chrono::duration<double>(elapsed).count(), burst);
+    }
+
+    bool consume_sdo_budget(const StorageUnit& storage, Operation::State state) {
+        double size = sizeof(protocol::sdo::Read);
+        if (state == Operation::State::WRITING)
+            size = double(sizeof(protocol::sdo::Read) + (size_t{1} << int(storage.info.size)));
+        if (sdo_budget_ < size) {
+            Statistics::increase(traffic_.deferred_sdo_requests);
+            return false;
+        }
+        sdo_budget_ -= size;
+        return true;
+    }
+
+    void update_traffic_rates(std::chrono::steady_clock::time_point now) {
+        auto elapsed = now - traffic_.window_begin;
+        if (elapsed < std::chrono::seconds(1))
+            return;
+
+        auto sdo_bytes = traffic_.sdo_bytes.load(std::memory_order::relaxed);
+        auto pdo_bytes = traffic_.pdo_bytes.load(std::memory_order::relaxed);
+        auto seconds = std::chrono::duration<double>(elapsed).count();
+        traffic_.sdo_bytes_per_second.store(
+            static_cast<uint64_t>(double(sdo_bytes - traffic_.window_sdo_bytes) / seconds),
+            std::memory_order::relaxed);
+        traffic_.pdo_bytes_per_second.store(
+            static_cast<uint64_t>(double(pdo_bytes - traffic_.window_pdo_bytes) / seconds),
+            std::memory_order::relaxed);
+        traffic_.window_begin = now;
+        traffic_.window_sdo_bytes = sdo_bytes;
+        traffic_.window_pdo_bytes = pdo_bytes;
+    }
+
+    void schedule_subscription_read(
+        StorageUnit& storage, Subscription& subscription,
+        std::chrono::steady_clock::duration::rep period, std::chrono::steady_clock::time_point now) {
+        auto next_point = std::chrono::steady_clock::time_point{
+            std::chrono::steady_clock::duration{
+                subscription.next_point.load(std::memory_order::relaxed)}};
+        if (now < next_point)
+            return;
+
+        // A busy unit (user operation or a still pending previous read) is retried next tick.
+        if (!try_claim(storage, Operation::Mode::READ))
+            return;
+
+        storage.timeout =
+            std::min(std::chrono::steady_clock::duration{period}, subscription_max_timeout);
+        storage.callback = nullptr;
+        publish(storage);
+
+        next_point += std::chrono::steady_clock::duration{period};
+        if (next_point <= now)
+            // Fell behind (e.g. the unit was busy): restart the schedule instead of bursting.
+            next_point = now + std::chrono::steady_clock::duration{period};
+        subscription.next_point.store(
+            next_point.time_since_epoch().count(), std::memory_order::relaxed);
+    }
+
     void read_pdo_frame(std::byte*& pointer, const std::byte* sentinel) {
         const auto& data = read_frame_struct<protocol::pdo::CommandResult>(
             pointer, sentinel, "PDO CommandResult frame");
@@ -636,12 +1843,18 @@ private:
     }
 
     void pdo_read_async_unchecked() {
+        last_pdo_point_.store(
+            std::chrono::steady_clock::now().time_since_epoch().count(),
+            std::memory_order::relaxed);
         std::byte* buffer = fetch_pdo_buffer(default_transmit_buffer_, sizeof(protocol::pdo::Read));
         new (buffer) protocol::pdo::Read{};
         default_transmit_buffer_.trigger_transmission();
     }
     void pdo_write_async_unchecked(
         bool upstream_enabled, const double (&target_positions)[5][4], uint32_t timestamp) {
+        last_pdo_point_.store(
+            std::chrono::steady_clock::now().time_since_epoch().count(),
+            std::memory_order::relaxed);
         std::byte* buffer =
             fetch_pdo_buffer(default_transmit_buffer_, sizeof(protocol::pdo::Write));
         auto payload = new (buffer) protocol::pdo::Write{};
@@ -670,11 +1883,18 @@ private:
 
     AsyncTransmitBuffer<protocol::Header> default_transmit_buffer_;
     AsyncTransmitBuffer<protocol::Header> tick_thread_transmit_buffer_;
+    // Only used by `write_immediately`.
+    static constexpr size_t emergency_transfer_count = 4;
+    static_assert(
+        sizeof(protocol::Header)
+            + max_immediate_write_count * sizeof(protocol::sdo::Write<uint64_t>)
+            + sizeof(protocol::CrcCheck)
+        <= size_t(max_transmit_length()));
+    AsyncTransmitBuffer<protocol::Header> emergency_transmit_buffer_;
     std::jthread event_thread_;
 
-    std::thread::id operation_thread_id_;
-
-    size_t storage_unit_count_;
+    size_t storage_unit_count_; // Including the raw units
+    size_t first_raw_unit_;
     std::unique_ptr<StorageUnit[]> storage_;
 
     struct IndexMapKey {
@@ -684,6 +1904,97 @@ private:
     };
     std::map<uint32_t, StorageUnit*> index_storage_map_;
 
+    Statistics statistics_;
+    Traffic traffic_;
+
+    // The PDO lane counts as active for this long after its last frame.
+    static constexpr std::chrono::steady_clock::duration pdo_activity_window =
+        std::chrono::milliseconds(10);
+    std::atomic<uint32_t> sdo_bandwidth_limit_ = default_sdo_bandwidth_limit; // Bytes/s, 0: none
+    std::atomic<std::chrono::steady_clock::duration::rep> last_pdo_point_ = 0;
+    std::chrono::steady_clock::time_point last_refill_point_; // Tick thread only
+    double sdo_budget_ = std::numeric_limits<double>::infinity(); // Tick thread only, in bytes
+
+    static constexpr int adaptive_timeout_rto_multiplier = 4;
+    static constexpr std::chrono::steady_clock::duration adaptive_timeout_min =
+        std::chrono::milliseconds(20);
+    static constexpr std::chrono::steady_clock::duration adaptive_timeout_max =
+        std::chrono::milliseconds(500);
+    RttEstimator rtt_;
+
+    // Tick thread only, kept outside `StorageUnit` like `update_points_`.
+    struct Retransmission {
+        std::chrono::steady_clock::time_point next_point;
+        std::chrono::steady_clock::duration interval;
+        Operation::State sent_state; // Of the operation when its last request was sent
+        uint64_t sent_value;         // Raw bytes of the last value written
+    };
+    static constexpr std::chrono::steady_clock::duration unsampled_retransmission_interval =
+        std::chrono::milliseconds(20);
+    static constexpr std::chrono::steady_clock::duration max_retransmission_interval =
+        std::chrono::milliseconds(100);
+    std::chrono::steady_clock::duration retransmission_backoff_{}; // Tick thread only
+    uint64_t backoff_samples_ = 0;                                 // Tick thread only
+
+    static constexpr size_t operation_queue_capacity = 4;
+    std::deque<utility::MpmcRingBuffer<QueuedOperation>> operation_queues_;
+
+    std::unique_ptr<BulkOperation[]> bulk_operations_;
+    utility::MpmcRingBuffer<uint32_t> free_bulk_operations_;
+
+    static constexpr std::chrono::steady_clock::duration subscription_max_timeout =
+        std::chrono::milliseconds(500);
+    std::unique_ptr<Subscription[]> subscriptions_;
+
+    // Steady clock ticks of the last successful read of each storage unit, 0 if never read.
+    // Kept outside `StorageUnit`, which is exactly one cache line.
+    std::unique_ptr<std::atomic<std::chrono::steady_clock::duration::rep>[]> update_points_;
+
+    // Incremented by `write_immediately` on each unit it writes. Queued writes submitted under
+    // an older epoch are dropped instead of started.
+    std::unique_ptr<std::atomic<uint32_t>[]> write_epochs_;
+    std::unique_ptr<Retransmission[]> retransmissions_;
+
+    // Storage units at the end of `storage_`, lent by the tick thread to raw operations.
+    static constexpr size_t raw_unit_count = 64;
+    static constexpr size_t raw_batch_queue_capacity = 64;
+    std::unique_ptr<std::atomic<uint32_t>[]> raw_unit_keys_; // `raw_object_key`, or 0 if idle
+    std::unique_ptr<RawBatch*[]> raw_unit_batches_;          // Tick thread only
+    utility::MpmcRingBuffer<std::unique_ptr<RawBatch>> submitted_raw_batches_;
+    std::deque<std::unique_ptr<RawBatch>> raw_batches_; // Tick thread only, in submission order
+    std::vector<uint32_t> free_raw_units_;              // Tick thread only, indices into the above
+
+    // Taken on the issuing thread, released on the thread that completes the operation.
+    std::unique_ptr<CompletionSlot[]> completion_slots_;
+    size_t completion_slot_count_;
+    std::atomic<size_t> next_completion_slot_ = 0;
+
+    // Shared by all `wait_for_update` callers; signalled from the receive path.
+    utility::EventCount update_event_;
+
+    // Odd while the event thread applies a received frame, see `get_consistent`.
+    std::atomic<uint32_t> receive_sequence_ = 0;
+
+    // Completions of operations submitted with `Handler::queue_completion`, produced by the tick
+    // thread and drained by `poll_completions`.
+    static constexpr size_t completion_queue_capacity = 1024;
+    utility::RingBuffer<Completion> completion_queue_{completion_queue_capacity};
+    std::atomic<size_t> completion_reservations_ = 0;
+    utility::EventCount completion_event_;
+
+    // Frames of `write_immediately`, counted when submitted and when transmitted.
+    std::mutex emergency_mutex_;
+    std::atomic<uint64_t> emergency_submitted_ = 0;
+    std::atomic<uint64_t> emergency_transmitted_ = 0;
+    std::atomic<std::chrono::steady_clock::duration::rep> emergency_transmit_point_ = 0;
+    utility::EventCount emergency_event_;
+
+    // Lets an idle tick thread sleep until there is work, see `wake_tick_thread`.
+    std::atomic<uint64_t> submissions_ = 0;
+    utility::EventCount tick_event_;
+    std::atomic<std::chrono::steady_clock::duration::rep> heartbeat_interval_ =
+        std::chrono::steady_clock::duration{default_heartbeat_interval}.count();
+
     std::jthread tick_thread_;
 
     std::atomic<int32_t> pdo_read_result_[5][4];
@@ -693,10 +2004,17 @@ private:
     std::jthread realtime_controller_thread_;
 };
 
+WUJIHANDCPP_API void
+    Handler::complete_slot(Buffer8 context, bool success, uint32_t error_code) {
+    Impl::complete_slot(context, success, error_code);
+}
+
 WUJIHANDCPP_API Handler::Handler(
     uint16_t usb_vid, int32_t usb_pid, const char* serial_number, size_t buffer_transfer_count,
-    size_t storage_unit_count) {
-    impl_ = new Impl{usb_vid, usb_pid, serial_number, buffer_transfer_count, storage_unit_count};
+    size_t storage_unit_count, size_t completion_slot_count) {
+    impl_ = new Impl{
+        usb_vid, usb_pid, serial_number, buffer_transfer_count, storage_unit_count,
+        completion_slot_count};
 }
 
 WUJIHANDCPP_API Handler::~Handler() { delete impl_; }
@@ -710,21 +2028,103 @@ WUJIHANDCPP_API void Handler::read_async_unchecked(
     impl_->read_async_unchecked(storage_id, timeout);
 }
 
+WUJIHANDCPP_API void Handler::read_async_unchecked_bulk(
+    const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep timeout) {
+    impl_->read_async_unchecked_bulk(storage_ids, count, timeout);
+}
+
 WUJIHANDCPP_API void Handler::read_async(
     int storage_id, std::chrono::steady_clock::duration::rep timeout,
-    void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
+    void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+    Buffer8 callback_context) {
     impl_->read_async(storage_id, timeout, callback, callback_context);
 }
 
+WUJIHANDCPP_API void Handler::read_async_bulk(
+    const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep timeout,
+    void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+    Buffer8 callback_context) {
+    impl_->read_async_bulk(storage_ids, count, timeout, callback, callback_context);
+}
+
+WUJIHANDCPP_API void Handler::queue_completion(Buffer8, bool, uint32_t) {
+    // Only its address matters: the handler recognizes it and queues the completion instead.
+}
+
 WUJIHANDCPP_API void Handler::write_async_unchecked(
-    Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout) {
-    impl_->write_async_unchecked(data, storage_id, timeout);
+    Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
+    WriteConfirmation confirmation) {
+    impl_->write_async_unchecked(data, storage_id, timeout, confirmation);
+}
+
+WUJIHANDCPP_API void Handler::write_async_unchecked_bulk(
+    const Buffer8* data, const int* storage_ids, size_t count,
+    std::chrono::steady_clock::duration::rep timeout, WriteConfirmation confirmation) {
+    impl_->write_async_unchecked_bulk(data, storage_ids, count, timeout, confirmation);
+}
+
+WUJIHANDCPP_API std::chrono::steady_clock::duration::rep Handler::write_immediately(
+    const Buffer8* data, const int* storage_ids, size_t count,
+    std::chrono::steady_clock::duration::rep timeout) {
+    return impl_->write_immediately(data, storage_ids, count, timeout);
 }
 
 WUJIHANDCPP_API void Handler::write_async(
     Buffer8 data, int storage_id, std::chrono::steady_clock::duration::rep timeout,
-    void (*callback)(Buffer8 context, bool success), Buffer8 callback_context) {
-    impl_->write_async(data, storage_id, timeout, callback, callback_context);
+    void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+    Buffer8 callback_context, WriteConfirmation confirmation) {
+    impl_->write_async(data, storage_id, timeout, callback, callback_context, confirmation);
+}
+
+WUJIHANDCPP_API void Handler::write_async_bulk(
+    const Buffer8* data, const int* storage_ids, size_t count,
+    std::chrono::steady_clock::duration::rep timeout,
+    void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+    Buffer8 callback_context, WriteConfirmation confirmation) {
+    impl_->write_async_bulk(
+        data, storage_ids, count, timeout, callback, callback_context, confirmation);
+}
+
+WUJIHANDCPP_API void Handler::transact_async(
+    TransactionItem* items, size_t count, std::chrono::steady_clock::duration::rep timeout,
+    void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+    Buffer8 callback_context) {
+    impl_->transact_async(items, count, timeout, callback, callback_context);
+}
+
+WUJIHANDCPP_API void Handler::raw_transact_async(
+    RawItem* items, size_t count, std::chrono::steady_clock::duration::rep timeout,
+    void (*callback)(Buffer8 context, bool success, uint32_t error_code),
+    Buffer8 callback_context) {
+    impl_->raw_transact_async(items, count, timeout, callback, callback_context);
+}
+
+WUJIHANDCPP_API Handler::CompletionSlot* Handler::acquire_completion_slot() {
+    return impl_->acquire_completion_slot();
+}
+
+WUJIHANDCPP_API void Handler::discard_completion_slot(CompletionSlot* slot) {
+    Impl::discard_completion_slot(slot);
+}
+
+WUJIHANDCPP_API size_t Handler::poll_completions(
+    Completion* completions, size_t max_count, std::chrono::steady_clock::duration::rep timeout) {
+    return impl_->poll_completions(completions, max_count, timeout);
+}
+
+WUJIHANDCPP_API void
+    Handler::set_write_confirmation(const int* storage_ids, size_t count, bool confirmed) {
+    impl_->set_write_confirmation(storage_ids, count, confirmed);
+}
+
+WUJIHANDCPP_API void Handler::subscribe(
+    const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep period) {
+    impl_->subscribe(storage_ids, count, period);
+}
+
+WUJIHANDCPP_API void
+    Handler::set_heartbeat_interval(std::chrono::steady_clock::duration::rep interval) {
+    impl_->set_heartbeat_interval(interval);
 }
 
 WUJIHANDCPP_API void Handler::attach_realtime_controller(
@@ -738,8 +2138,59 @@ WUJIHANDCPP_API device::IRealtimeController* Handler::detach_realtime_controller
 
 WUJIHANDCPP_API Handler::Buffer8 Handler::get(int storage_id) { return impl_->get(storage_id); }
 
-WUJIHANDCPP_API void Handler::disable_thread_safe_check() {
-    return impl_->disable_thread_safe_check();
+WUJIHANDCPP_API void
+    Handler::get_consistent(const int* storage_ids, size_t count, Buffer8* values) {
+    impl_->get_consistent(storage_ids, count, values);
 }
 
+WUJIHANDCPP_API Handler::Buffer8 Handler::get_with_version(int storage_id, uint32_t& version) {
+    return impl_->get_with_version(storage_id, version);
+}
+
+WUJIHANDCPP_API void Handler::restore_value(int storage_id, Buffer8 value) {
+    impl_->restore_value(storage_id, value);
+}
+
+WUJIHANDCPP_API std::chrono::steady_clock::duration::rep
+    Handler::get_update_point(int storage_id) {
+    return impl_->get_update_point(storage_id);
+}
+
+WUJIHANDCPP_API size_t Handler::select_stale(
+    const int* storage_ids, size_t count, std::chrono::steady_clock::duration::rep max_age,
+    int* stale_storage_ids) {
+    return impl_->select_stale(storage_ids, count, max_age, stale_storage_ids);
+}
+
+WUJIHANDCPP_API void
+    Handler::get_versions(const int* storage_ids, size_t count, uint32_t* versions) {
+    impl_->get_versions(storage_ids, count, versions);
+}
+
+WUJIHANDCPP_API bool Handler::wait_for_update(
+    const int* storage_ids, const uint32_t* versions, size_t count,
+    std::chrono::steady_clock::duration::rep timeout) {
+    return impl_->wait_for_update(storage_ids, versions, count, timeout);
+}
+
+WUJIHANDCPP_API Handler::SdoStatistics Handler::sdo_statistics() {
+    return impl_->sdo_statistics();
+}
+
+WUJIHANDCPP_API Handler::TrafficStatistics Handler::traffic_statistics() {
+    return impl_->traffic_statistics();
+}
+
+WUJIHANDCPP_API void Handler::set_sdo_bandwidth_limit(uint32_t bytes_per_second) {
+    impl_->set_sdo_bandwidth_limit(bytes_per_second);
+}
+
+WUJIHANDCPP_API Handler::RttStatistics Handler::rtt_statistics() {
+    return impl_->rtt_statistics();
+}
+
+WUJIHANDCPP_API const char* Handler::serial_number() { return impl_->serial_number().c_str(); }
+
+WUJIHANDCPP_API void Handler::disable_thread_safe_check() {}
+
 } // namespace wujihandcpp::protocol
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+
+namespace wujihandcpp::protocol {
+
+// State of the operation pending on a storage unit, swapped atomically as a whole.
+struct Operation {
+    enum class Mode : uint8_t {
+        NONE = 0,
+
+        READ,
+        WRITE,
+        // Completes on the write acknowledgement, without reading the value back.
+        WRITE_UNCONFIRMED
+    } mode;
+    enum class State : uint8_t {
+        SUCCESS = 0,
+
+        // The issuing thread owns the storage unit and is filling in its fields.
+        PREPARING,
+        WAITING,
+
+        READING,
+        // The receive thread owns the storage unit and is publishing the value read.
+        RESPONDING,
+
+        WRITING,
+        WRITING_CONFIRMING,
+
+        // The device answered with an SDO error response, see `StorageUnit::error_code`.
+        FAILED,
+        // Failed without a response, see `Handler::write_immediately`.
+        CANCELLED,
+    } state;
+    // Changes whenever a response may no longer belong to the operation: when the unit is
+    // claimed for a new operation, and when a sent write gets a new value.
+    uint16_t generation = 0;
+
+    // An idle unit claimed for a new operation in `mode`.
+    constexpr Operation claimed(Mode new_mode) const {
+        return {.mode = new_mode, .state = State::PREPARING, .generation = next_generation()};
+    }
+
+    // Whether an unchecked write may replace the value of this operation instead of queueing
+    // behind it. The new value must still reach the device: a write that has not been sent yet
+    // sends it, and a confirmed write is sent again and confirmed against it. An unconfirmed
+    // write that was already sent may be acknowledged for the old value, and a finished or
+    // failed one sends nothing more.
+    constexpr bool can_be_superseded() const {
+        switch (state) {
+        case State::WAITING: return mode == Mode::WRITE || mode == Mode::WRITE_UNCONFIRMED;
+        case State::WRITING:
+        case State::WRITING_CONFIRMING: return mode == Mode::WRITE;
+        default: return false;
+        }
+    }
+
+    // This operation after its value was replaced, see `can_be_superseded`. A write that was
+    // already sent is sent again, and responses to the old value are told apart.
+    constexpr Operation superseded() const {
+        if (state == State::WAITING)
+            return *this;
+        return {.mode = mode, .state = State::WRITING, .generation = next_generation()};
+    }
+
+    // Whether this is an unconfirmed write that was already sent and keeps being resent until
+    // acknowledged. It cannot be superseded, so it must be cancelled to stop its value.
+    constexpr bool can_be_cancelled() const {
+        return mode == Mode::WRITE_UNCONFIRMED && state == State::WRITING;
+    }
+
+    // Moves `operation` from the `observed` operation on to `new_state`. Fails if another thread
+    // changed the operation since it was observed, in which case the caller must drop whatever
+    // it observed, such as a response.
+    static bool transition(
+        std::atomic<Operation>& operation, Operation observed, State new_state,
+        std::memory_order order = std::memory_order::acq_rel) {
+        auto desired = observed;
+        desired.state = new_state;
+        return operation.compare_exchange_strong(
+            observed, desired, order, std::memory_order::relaxed);
+    }
+
+private:
+    constexpr uint16_t next_generation() const { return uint16_t(generation + 1); }
+};
+
+} // namespace wujihandcpp::protocol
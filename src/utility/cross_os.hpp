@@ -1,5 +1,9 @@
 #pragma once
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <immintrin.h>
+#endif
+
 namespace wujihandcpp::utility {
 
 #ifdef _MSC_VER
@@ -32,4 +36,17 @@ constexpr static inline bool is_windows() {
 # define ALWAYS_INLINE inline
 #endif
 
+// Hints the CPU that the caller is in a spin-wait loop.
+ALWAYS_INLINE void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __yield();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
 } // namespace wujihandcpp::utility
\ No newline at end of file
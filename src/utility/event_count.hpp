@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+
+#include "utility/final_action.hpp"
+#include "utility/futex.hpp"
+
+namespace wujihandcpp::utility {
+
+// Lets threads block until a condition published by another thread holds. The notifier only
+// pays for a fence and a load while nobody is waiting; the syscall is reserved for real waiters.
+class EventCount {
+public:
+    /*!
+     * \brief Blocks until `predicate` returns true, for at most `timeout` (negative: no limit)
+     * \return The last result of `predicate`
+     */
+    template <typename Predicate>
+    bool wait_until(Predicate&& predicate, std::chrono::steady_clock::duration timeout) {
+        if (predicate())
+            return true;
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        waiters_.fetch_add(1, std::memory_order::relaxed);
+        FinalAction leave{[this]() { waiters_.fetch_sub(1, std::memory_order::relaxed); }};
+        // Pairs with the fence in `notify_all`: either the notifier sees this waiter, or this
+        // thread sees the published condition below.
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+
+        while (true) {
+            auto sequence = sequence_.load(std::memory_order::acquire);
+            if (predicate())
+                return true;
+
+            auto remaining = std::chrono::steady_clock::duration{-1};
+            if (timeout >= std::chrono::steady_clock::duration::zero()) {
+                remaining = timeout - (std::chrono::steady_clock::now() - begin);
+                if (remaining <= std::chrono::steady_clock::duration::zero())
+                    return predicate();
+            }
+            futex_wait(sequence_, sequence, remaining);
+        }
+    }
+
+    // Call after publishing the condition.
+    void notify_all() {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (waiters_.load(std::memory_order::relaxed) == 0)
+            return;
+        sequence_.fetch_add(1, std::memory_order::release);
+        futex_wake_all(sequence_);
+    }
+
+private:
+    std::atomic<uint32_t> sequence_ = 0;
+    std::atomic<uint32_t> waiters_ = 0;
+};
+
+} // namespace wujihandcpp::utility
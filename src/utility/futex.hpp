@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+# include <cerrno>
+# include <ctime>
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#elif defined(_WIN32)
+# include <windows.h>
+#endif
+
+namespace wujihandcpp::utility {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Thin wrappers over the OS address-wait primitives. Unlike std::atomic::wait, they support a
+// timeout, and a waiter does not need to be registered in the standard library's waiter pool.
+
+/*!
+ * \brief Blocks while `word` holds `expected`, for at most `timeout` (negative: no limit)
+ * \return false if the timeout expired, true otherwise (including spurious wake-ups)
+ */
+inline bool futex_wait(
+    std::atomic<uint32_t>& word, uint32_t expected, std::chrono::steady_clock::duration timeout) {
+#if defined(__linux__)
+    timespec relative_timeout{};
+    if (timeout >= std::chrono::steady_clock::duration::zero()) {
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        relative_timeout.tv_sec = static_cast<time_t>(seconds.count());
+        relative_timeout.tv_nsec = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count());
+    }
+
+    long ret = syscall(
+        SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected,
+        timeout >= std::chrono::steady_clock::duration::zero() ? &relative_timeout : nullptr,
+        nullptr, 0);
+    return !(ret == -1 && errno == ETIMEDOUT);
+#elif defined(_WIN32)
+    DWORD milliseconds = INFINITE;
+    if (timeout >= std::chrono::steady_clock::duration::zero())
+        milliseconds = static_cast<DWORD>(
+            std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+
+    if (WaitOnAddress(&word, &expected, sizeof(expected), milliseconds))
+        return true;
+    return GetLastError() != ERROR_TIMEOUT;
+#else
+    // No address-wait primitive: degrade to short sleeps.
+    if (word.load(std::memory_order::relaxed) != expected)
+        return true;
+    auto slice = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::milliseconds(1));
+    if (timeout >= std::chrono::steady_clock::duration::zero() && timeout < slice) {
+        std::this_thread::sleep_for(timeout);
+        return false;
+    }
+    std::this_thread::sleep_for(slice);
+    return true;
+#endif
+}
+
+inline void futex_wake_all(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    syscall(
+        SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr,
+        nullptr, 0);
+#elif defined(_WIN32)
+    WakeByAddressAll(&word);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace wujihandcpp::utility
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace wujihandcpp::utility {
+
+// Lock-free bounded Multi-Producer/Multi-Consumer (MPMC) ring buffer
+// After Dmitry Vyukov's bounded queue: every cell carries a sequence number that tells producers
+// and consumers whose turn it is, so neither side needs a lock. Room is reserved up front, which
+// lets a producer claim several entries all-or-nothing before filling them in.
+template <typename T>
+class MpmcRingBuffer {
+public:
+    explicit MpmcRingBuffer(size_t size) {
+        if (size <= 2)
+            size = 2;
+        else
+            size = round_up_to_next_power_of_2(size);
+        mask = size - 1;
+        cells_ = new Cell[size];
+        for (size_t i = 0; i < size; i++)
+            cells_[i].sequence.store(i, std::memory_order::relaxed);
+    }
+
+    MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+    MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+    ~MpmcRingBuffer() {
+        clear();
+        delete[] cells_;
+    }
+
+    size_t max_size() const { return mask + 1; }
+
+    /*!
+     * \brief Check how many elements have been (or are being) pushed and not yet popped
+     *
+     * Exact only while no other thread uses the buffer, but never 0 while an element pushed
+     * before the call is still in the buffer.
+     */
+    size_t readable() const {
+        return in_.load(std::memory_order::acquire) - out_.load(std::memory_order::acquire);
+    }
+
+    /*!
+     * \brief Reserve room for `count` elements, to be filled with `emplace_reserved`
+     * \return false, reserving nothing, if fewer than `count` slots are free
+     */
+    bool reserve(size_t count = 1) {
+        auto reserved = reserved_.load(std::memory_order::relaxed);
+        do {
+            if (count > max_size() - reserved)
+                return false;
+        } while (!reserved_.compare_exchange_weak(
+            reserved, reserved + count, std::memory_order::acquire, std::memory_order::relaxed));
+        return true;
+    }
+
+    /*!
+     * \brief Give back reserved room that will not be filled
+     */
+    void release(size_t count = 1) { reserved_.fetch_sub(count, std::memory_order::release); }
+
+    /*!
+     * \brief Construct an element in previously reserved room
+     */
+    template <typename... Args>
+    void emplace_reserved(Args&&... args) {
+        auto in = in_.fetch_add(1, std::memory_order::relaxed);
+        auto& cell = cells_[in & mask];
+        // The reservation guarantees that the previous lap's element has been popped, but its
+        // consumer may not have handed the cell back yet.
+        while (cell.sequence.load(std::memory_order::acquire) != in)
+            std::this_thread::yield();
+        new (cell.data) T{std::forward<Args>(args)...};
+        cell.sequence.store(in + 1, std::memory_order::release);
+    }
+
+    template <typename... Args>
+    bool emplace_back(Args&&... args) {
+        if (!reserve())
+            return false;
+        emplace_reserved(std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool push_back(const T& value) { return emplace_back(value); }
+    bool push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    /*!
+     * \brief Gets the first element in the buffer on consumed side
+     *
+     * Only valid while there is a single consumer
+     *
+     * \return Pointer to first element, nullptr if buffer was empty or the first element is
+     *         still being pushed
+     */
+    T* front() {
+        auto out = out_.load(std::memory_order::relaxed);
+        auto& cell = cells_[out & mask];
+        if (cell.sequence.load(std::memory_order::acquire) != out + 1)
+            return nullptr;
+        return std::launder(reinterpret_cast<T*>(cell.data));
+    }
+
+    template <typename F>
+    requires requires(F f, T t) { f(std::move(t)); } bool pop_front(F&& callback_functor) {
+        auto out = out_.load(std::memory_order::relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[out & mask];
+            auto sequence = cell->sequence.load(std::memory_order::acquire);
+            if (sequence != out + 1) {
+                if (static_cast<std::ptrdiff_t>(sequence - (out + 1)) < 0)
+                    return false;
+                out = out_.load(std::memory_order::relaxed);
+            } else if (out_.compare_exchange_weak(out, out + 1, std::memory_order::relaxed)) {
+                break;
+            }
+        }
+
+        auto& element = *std::launder(reinterpret_cast<T*>(cell->data));
+        callback_functor(std::move(element));
+        std::destroy_at(&element);
+        cell->sequence.store(out + max_size(), std::memory_order::release);
+        release();
+        return true;
+    }
+
+    /*!
+     * \brief Clear buffer
+     * \return Number of elements that be erased
+     */
+    size_t clear() {
+        size_t count = 0;
+        while (pop_front([](T&&) {}))
+            count++;
+        return count;
+    }
+
+private:
+    constexpr static size_t round_up_to_next_power_of_2(size_t n) {
+        n--;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        n |= n >> 32;
+        n++;
+        return n;
+    }
+
+    size_t mask;
+
+    std::atomic<size_t> reserved_{0};
+    alignas(64) std::atomic<size_t> in_{0};
+    alignas(64) std::atomic<size_t> out_{0};
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) std::byte data[sizeof(T)];
+    }* cells_;
+};
+
+}; // namespace wujihandcpp::utility
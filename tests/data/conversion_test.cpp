@@ -0,0 +1,61 @@
+#include <cstdint>
+
+#include <limits>
+#include <numbers>
+
+#include "wujihandcpp/data/hand.hpp"
+#include "wujihandcpp/data/joint.hpp"
+
+#include <gtest/gtest.h>
+
+namespace wujihandcpp::data {
+
+TEST(ConversionTest, KindIsResolvedFromTheDataType) {
+    EXPECT_EQ(conversion_kind<hand::FirmwareVersion>(), StorageInfo::NONE);
+    EXPECT_EQ(conversion_kind<joint::Enabled>(), StorageInfo::CONTROL_WORD);
+    EXPECT_EQ(conversion_kind<joint::ActualPosition>(), StorageInfo::POSITION);
+    EXPECT_EQ(conversion_kind<joint::UpperLimit>(), StorageInfo::POSITION);
+}
+
+TEST(ConversionTest, ControlWord) {
+    using Conversion = ConversionOf<joint::Enabled>;
+    EXPECT_EQ(Conversion::to_raw(true, 0).as<uint16_t>(), 1);
+    EXPECT_EQ(Conversion::to_raw(false, 0).as<uint16_t>(), 5);
+    EXPECT_TRUE(Conversion::from_raw<bool>(protocol::Handler::Buffer8{uint16_t{1}}, 0));
+    EXPECT_FALSE(Conversion::from_raw<bool>(protocol::Handler::Buffer8{uint16_t{5}}, 0));
+}
+
+TEST(ConversionTest, PositionFollowsTheJointDirection) {
+    using Conversion = ConversionOf<joint::TargetPosition>;
+    // J1 of the index finger is reversed, J2 is not.
+    auto forward = joint::TargetPosition::info(0x0101).policy;
+    auto reversed = joint::TargetPosition::info(0x0100).policy;
+    ASSERT_FALSE(forward & StorageInfo::POSITION_REVERSED);
+    ASSERT_TRUE(reversed & StorageInfo::POSITION_REVERSED);
+
+    auto raw = Conversion::to_raw(std::numbers::pi / 2, forward);
+    EXPECT_EQ(raw.as<int32_t>(), std::numeric_limits<int32_t>::max() / 4 + 1);
+    EXPECT_EQ(
+        Conversion::to_raw(std::numbers::pi / 2, reversed).as<int32_t>(), -raw.as<int32_t>());
+    EXPECT_NEAR(Conversion::from_raw<double>(raw, forward), std::numbers::pi / 2, 1e-8);
+    EXPECT_NEAR(Conversion::from_raw<double>(raw, reversed), -std::numbers::pi / 2, 1e-8);
+
+    // Out of range angles saturate, in both directions.
+    EXPECT_EQ(
+        Conversion::to_raw(10.0, forward).as<int32_t>(), std::numeric_limits<int32_t>::max());
+    EXPECT_EQ(
+        Conversion::to_raw(10.0, reversed).as<int32_t>(), std::numeric_limits<int32_t>::min());
+}
+
+TEST(ConversionTest, VelocityIsScaledPerSecond) {
+    using Conversion = Conversion<StorageInfo::VELOCITY>;
+    auto forward = joint::internal::velocity_policy(0x0101);
+    auto reversed = joint::internal::velocity_policy(0x0100);
+
+    auto raw = Conversion::to_raw(-std::numbers::pi, forward);
+    EXPECT_EQ(raw.as<int32_t>(), -(std::numeric_limits<int32_t>::max() / 2 + 1));
+    EXPECT_NEAR(Conversion::from_raw<double>(raw, forward), -std::numbers::pi, 1e-8);
+    EXPECT_NEAR(Conversion::from_raw<double>(raw, reversed), std::numbers::pi, 1e-8);
+}
+
+} // namespace wujihandcpp::data
@@ -63,6 +63,37 @@ TEST(LatchTest, WaitAggregatesMultipleFailures) {
     EXPECT_TRUE(latch.try_wait());
 }
 
+TEST(LatchTest, WaitThrowsSdoErrorWithFirstErrorCode) {
+    Latch latch;
+    latch.count_up();
+    latch.count_up();
+    latch.count_up();
+
+    std::thread worker([&]() {
+        std::this_thread::sleep_for(10ms);
+        latch.count_down(false);
+        latch.count_down(false, 0x06020000);
+        latch.count_down(false, 0x06010002);
+    });
+
+    try {
+        latch.wait();
+        FAIL() << "SdoError expected";
+    } catch (const SdoError& error) {
+        EXPECT_EQ(0x06020000u, error.error_code());
+        EXPECT_STREQ(
+            "3 operations failed while waiting for completion, first SDO error 0x06020000",
+            error.what());
+    }
+
+    worker.join();
+    EXPECT_TRUE(latch.try_wait());
+
+    latch.count_up();
+    latch.count_down(true);
+    EXPECT_NO_THROW(latch.wait());
+}
+
 TEST(LatchTest, ReuseAfterFailureSucceeds) {
     Latch latch;
     latch.count_up();
@@ -87,6 +118,77 @@ TEST(LatchTest, ReuseAfterFailureSucceeds) {
     EXPECT_TRUE(latch.try_wait());
 }
 
+TEST(LatchTest, WaitForTimesOutWhileOperationsArePending) {
+    Latch latch;
+    latch.count_up();
+
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_FALSE(latch.wait_for(20ms));
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, 20ms);
+    EXPECT_FALSE(latch.wait_until(std::chrono::steady_clock::now()));
+
+    std::thread worker([&]() {
+        std::this_thread::sleep_for(10ms);
+        latch.count_down(false);
+    });
+
+    EXPECT_THROW(latch.wait_for(10s), TimeoutError);
+    worker.join();
+    EXPECT_TRUE(latch.wait_for(0ms));
+}
+
+TEST(LatchTest, WaitCompletesWithinAndBeyondTheSpinPhase) {
+    Latch::set_spin_limit(1ms);
+
+    for (std::chrono::microseconds delay : {0us, 100us, 5000us}) {
+        Latch latch;
+        latch.count_up();
+
+        std::thread worker([&]() {
+            std::this_thread::sleep_for(delay);
+            latch.count_down(true);
+        });
+
+        EXPECT_TRUE(latch.wait_for(10s));
+        worker.join();
+    }
+
+    Latch::set_spin_limit(0ms);
+    Latch latch;
+    latch.count_up();
+    std::thread worker([&]() { latch.count_down(true); });
+    EXPECT_NO_THROW(latch.wait());
+    worker.join();
+}
+
+TEST(LatchTest, SpinBudgetFollowsTheObservedWaits) {
+    Latch::set_spin_limit(1ms);
+    auto wait_with_delay = [](std::chrono::microseconds delay, int count) {
+        for (int i = 0; i < count; i++) {
+            Latch latch;
+            latch.count_up();
+            std::thread worker([&]() {
+                std::this_thread::sleep_for(delay);
+                latch.count_down(true);
+            });
+            latch.wait();
+            worker.join();
+        }
+    };
+
+    // Slower than the limit: waits block right away.
+    wait_with_delay(5000us, 8);
+    EXPECT_EQ(Latch::spin_budget(), 0ms);
+
+    // Spinning resumes once waits are short again, although they blocked meanwhile.
+    wait_with_delay(100us, 32);
+    EXPECT_GT(Latch::spin_budget(), 0ms);
+    EXPECT_LE(Latch::spin_budget(), 1ms);
+
+    Latch::set_spin_limit(0ms);
+    EXPECT_EQ(Latch::spin_budget(), 0ms);
+}
+
 TEST(LatchTest, HandlesHighVolumeSuccessfulOperations) {
     Latch latch;
     constexpr int kThreads = 8;
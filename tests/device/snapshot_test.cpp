@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstdio>
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define private public
+#include "wujihandcpp/device/snapshot.hpp"
+#undef private
+
+#include <gtest/gtest.h>
+
+namespace wujihandcpp::device {
+
+namespace {
+
+std::string temporary_path(const char* name) {
+    return std::string{::testing::TempDir()} + name;
+}
+
+} // namespace
+
+TEST(SnapshotTest, SaveAndLoadRoundTrip) {
+    Snapshot snapshot;
+    using Buffer8 = protocol::Handler::Buffer8;
+    snapshot.serial_number_ = "WJH0123";
+    snapshot.records_.push_back(Snapshot::Record{0, Buffer8{uint32_t{0x03010000}}});
+    snapshot.records_.push_back(Snapshot::Record{513, Buffer8{uint16_t{1000}}});
+    snapshot.records_.push_back(Snapshot::Record{65535, Buffer8{-1.5}});
+
+    auto path = temporary_path("snapshot_round_trip.bin");
+    snapshot.save(path.c_str());
+    auto loaded = Snapshot::load(path.c_str());
+    std::remove(path.c_str());
+
+    EXPECT_EQ(loaded.serial_number(), "WJH0123");
+    ASSERT_EQ(loaded.size(), 3u);
+    EXPECT_EQ(loaded[0].storage_id, 0);
+    EXPECT_EQ(loaded[0].value.as<uint32_t>(), 0x03010000u);
+    EXPECT_EQ(loaded[1].storage_id, 513);
+    EXPECT_EQ(loaded[1].value.as<uint16_t>(), 1000);
+    EXPECT_EQ(loaded[2].storage_id, 65535);
+    EXPECT_EQ(loaded[2].value.as<double>(), -1.5);
+}
+
+TEST(SnapshotTest, VersionOneFilesLoadWithoutSerialNumber) {
+    uint8_t file_data[Snapshot::header_size + Snapshot::record_size] = {
+        'W', 'J', 'H', 'S', 1, 0, 1, 0, 0x01, 0x02, 0xE8, 0x03};
+    auto path = temporary_path("snapshot_version_one.bin");
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fwrite(file_data, sizeof(file_data), 1, file);
+    std::fclose(file);
+    auto loaded = Snapshot::load(path.c_str());
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(loaded.serial_number().empty());
+    ASSERT_EQ(loaded.size(), 1u);
+    EXPECT_EQ(loaded[0].storage_id, 0x0201);
+    EXPECT_EQ(loaded[0].value.as<uint16_t>(), 1000);
+}
+
+TEST(SnapshotTest, LoadRejectsMissingAndMalformedFiles) {
+    EXPECT_THROW(
+        Snapshot::load(temporary_path("snapshot_missing.bin").c_str()), std::runtime_error);
+
+    auto path = temporary_path("snapshot_malformed.bin");
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("not a snapshot", file);
+    std::fclose(file);
+    EXPECT_THROW(Snapshot::load(path.c_str()), std::runtime_error);
+
+    // A header announcing two records, followed by only one.
+    uint8_t truncated[Snapshot::header_size + Snapshot::record_size] = {
+        'W', 'J', 'H', 'S', 1, 0, 2, 0};
+    file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fwrite(truncated, sizeof(truncated), 1, file);
+    std::fclose(file);
+    EXPECT_THROW(Snapshot::load(path.c_str()), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+} // namespace wujihandcpp::device
@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define private public
+#define protected public
+#include "wujihandcpp/device/hand.hpp"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+namespace wujihandcpp::device {
+
+namespace {
+
+// The storage id `Hand::sub(f).sub(j)` assigns to joint data `Data`.
+template <typename Data>
+constexpr int joint_storage_id(int f, int j) {
+    return Hand::Datas::count + f * Finger::data_count() + Finger::Datas::count
+         + j * Joint::data_count() + Joint::Datas::index<Data>();
+}
+
+} // namespace
+
+TEST(StorageLayoutTest, HandTableMatchesTheOperatorTree) {
+    using Data = data::joint::TargetPosition;
+    constexpr auto offsets = DataOperator<Hand>::storage_id_offsets<Data>(
+        std::make_integer_sequence<int, DataOperator<Hand>::storage_count_of<Data>()>{});
+    static_assert(offsets.size() == 20, "");
+    static_assert(offsets[0] == joint_storage_id<Data>(0, 0), "");
+    static_assert(offsets[19] == joint_storage_id<Data>(4, 3), "");
+
+    for (int f = 0; f < 5; f++)
+        for (int j = 0; j < 4; j++) {
+            EXPECT_EQ(offsets[f * 4 + j], joint_storage_id<Data>(f, j));
+            EXPECT_EQ(
+                DataOperator<Hand>::unit_path<Data>(Hand::path_, f * 4 + j),
+                uint32_t(f << 8 | j));
+        }
+}
+
+TEST(StorageLayoutTest, FingerAndJointTablesAreRelative) {
+    using Data = data::joint::ActualPosition;
+    constexpr auto offsets = DataOperator<Finger>::storage_id_offsets<Data>(
+        std::make_integer_sequence<int, DataOperator<Finger>::storage_count_of<Data>()>{});
+    ASSERT_EQ(offsets.size(), 4u);
+    for (int j = 0; j < 4; j++) {
+        EXPECT_EQ(
+            Hand::Datas::count + 2 * Finger::data_count() + offsets[size_t(j)],
+            joint_storage_id<Data>(2, j));
+        EXPECT_EQ(DataOperator<Finger>::unit_path<Data>(2, j), uint32_t(2 << 8 | j));
+    }
+
+    EXPECT_EQ(DataOperator<Joint>::storage_id_offset<Data>(0), Joint::Datas::index<Data>());
+    EXPECT_EQ(DataOperator<Joint>::unit_path<Data>(0x0301, 0), 0x0301u);
+}
+
+TEST(StorageLayoutTest, SelectionArraysFollowTheOperatorTree) {
+    using Data = data::joint::ActualPosition;
+    static_assert(
+        std::is_same<
+            decltype(&Hand::get_all<Data>), void (DataOperator<Hand>::*)(double (&)[5][4])>::value,
+        "");
+    static_assert(
+        std::is_same<
+            decltype(&Finger::get_all<Data>), void (DataOperator<Finger>::*)(double (&)[4])>::value,
+        "");
+
+    double flat[20], shaped[5][4], copy[20];
+    for (int k = 0; k < 20; k++)
+        flat[k] = k;
+    EXPECT_EQ(DataOperator<Hand>::unflatten(shaped, flat), flat + 20);
+    for (int f = 0; f < 5; f++)
+        for (int j = 0; j < 4; j++)
+            EXPECT_EQ(shaped[f][j], f * 4 + j);
+    EXPECT_EQ(DataOperator<Hand>::flatten(shaped, copy), copy + 20);
+    for (int k = 0; k < 20; k++)
+        EXPECT_EQ(copy[k], k);
+}
+
+} // namespace wujihandcpp::device
@@ -0,0 +1,99 @@
+#include "protocol/operation.hpp"
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+namespace wujihandcpp::protocol {
+
+namespace {
+
+using Mode = Operation::Mode;
+using State = Operation::State;
+
+constexpr Operation operation(Mode mode, State state) { return {.mode = mode, .state = state}; }
+
+} // namespace
+
+TEST(OperationTest, WriteAfterFailedWriteIsQueued) {
+    EXPECT_FALSE(operation(Mode::WRITE, State::FAILED).can_be_superseded());
+    EXPECT_FALSE(operation(Mode::WRITE_UNCONFIRMED, State::FAILED).can_be_superseded());
+}
+
+TEST(OperationTest, FinishedOrUnpublishedWritesAreNotSuperseded) {
+    for (auto mode : {Mode::WRITE, Mode::WRITE_UNCONFIRMED}) {
+        EXPECT_FALSE(operation(mode, State::SUCCESS).can_be_superseded());
+        EXPECT_FALSE(operation(mode, State::PREPARING).can_be_superseded());
+    }
+}
+
+TEST(OperationTest, PendingWritesAreSupersededWhileTheNewValueIsStillSent) {
+    EXPECT_TRUE(operation(Mode::WRITE, State::WAITING).can_be_superseded());
+    EXPECT_TRUE(operation(Mode::WRITE, State::WRITING).can_be_superseded());
+    EXPECT_TRUE(operation(Mode::WRITE, State::WRITING_CONFIRMING).can_be_superseded());
+
+    // Once sent, an unconfirmed write may be acknowledged for its old value.
+    EXPECT_TRUE(operation(Mode::WRITE_UNCONFIRMED, State::WAITING).can_be_superseded());
+    EXPECT_FALSE(operation(Mode::WRITE_UNCONFIRMED, State::WRITING).can_be_superseded());
+}
+
+TEST(OperationTest, ReadsAreNeverSuperseded) {
+    EXPECT_FALSE(operation(Mode::READ, State::WAITING).can_be_superseded());
+    EXPECT_FALSE(operation(Mode::READ, State::READING).can_be_superseded());
+    EXPECT_FALSE(operation(Mode::NONE, State::SUCCESS).can_be_superseded());
+}
+
+TEST(OperationTest, ResponseAfterSupersedingWriteIsDropped) {
+    // The read-back of the old value was observed before the new value superseded it.
+    std::atomic<Operation> atomic = operation(Mode::WRITE, State::WRITING_CONFIRMING);
+    auto observed = atomic.load();
+    atomic.store(observed.superseded());
+    EXPECT_FALSE(Operation::transition(atomic, observed, State::SUCCESS));
+    EXPECT_EQ(atomic.load().state, State::WRITING);
+
+    // Even once the new value is sent and awaits its own read-back.
+    auto resent = atomic.load();
+    ASSERT_TRUE(Operation::transition(atomic, resent, State::WRITING_CONFIRMING));
+    EXPECT_FALSE(Operation::transition(atomic, observed, State::SUCCESS));
+    EXPECT_TRUE(Operation::transition(atomic, atomic.load(), State::SUCCESS));
+}
+
+TEST(OperationTest, LateResponseCannotUndoTimeout) {
+    std::atomic<Operation> atomic = operation(Mode::READ, State::READING);
+    auto observed = atomic.load();
+
+    // Timed out and completed by the tick thread, then claimed for the next read.
+    auto completed = observed;
+    completed.mode = Mode::NONE;
+    atomic.store(completed);
+    EXPECT_FALSE(Operation::transition(atomic, observed, State::RESPONDING));
+
+    auto next = completed.claimed(Mode::READ);
+    next.state = State::READING;
+    atomic.store(next);
+    EXPECT_FALSE(Operation::transition(atomic, observed, State::RESPONDING));
+    EXPECT_TRUE(Operation::transition(atomic, next, State::RESPONDING));
+}
+
+TEST(OperationTest, SupersedingAWaitingWriteKeepsIt) {
+    auto waiting = operation(Mode::WRITE, State::WAITING);
+    auto superseded = waiting.superseded();
+    EXPECT_EQ(superseded.state, State::WAITING);
+    EXPECT_EQ(superseded.generation, waiting.generation);
+}
+
+TEST(OperationTest, OnlySentUnconfirmedWritesAreCancelled) {
+    EXPECT_TRUE(operation(Mode::WRITE_UNCONFIRMED, State::WRITING).can_be_cancelled());
+    EXPECT_FALSE(operation(Mode::WRITE_UNCONFIRMED, State::WAITING).can_be_cancelled());
+    EXPECT_FALSE(operation(Mode::WRITE, State::WRITING).can_be_cancelled());
+    EXPECT_FALSE(operation(Mode::READ, State::READING).can_be_cancelled());
+
+    // The acknowledgement of a cancelled write is dropped.
+    std::atomic<Operation> atomic = operation(Mode::WRITE_UNCONFIRMED, State::WRITING);
+    auto observed = atomic.load();
+    ASSERT_TRUE(Operation::transition(atomic, observed, State::CANCELLED));
+    EXPECT_FALSE(Operation::transition(atomic, observed, State::SUCCESS));
+    EXPECT_EQ(atomic.load().state, State::CANCELLED);
+}
+
+} // namespace wujihandcpp::protocol
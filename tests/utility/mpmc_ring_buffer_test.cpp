@@ -0,0 +1,109 @@
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utility/mpmc_ring_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+namespace wujihandcpp::utility {
+
+TEST(MpmcRingBufferTest, ReservesAllOrNothing) {
+    MpmcRingBuffer<int> buffer{4};
+    EXPECT_TRUE(buffer.reserve(3));
+    EXPECT_FALSE(buffer.reserve(2));
+    EXPECT_TRUE(buffer.reserve(1));
+    EXPECT_FALSE(buffer.emplace_back(0));
+
+    buffer.release(2);
+    buffer.emplace_reserved(1);
+    buffer.emplace_reserved(2);
+    EXPECT_EQ(buffer.readable(), 2u);
+    EXPECT_TRUE(buffer.emplace_back(3));
+    EXPECT_TRUE(buffer.emplace_back(4));
+    EXPECT_FALSE(buffer.emplace_back(5));
+
+    int value = 0;
+    ASSERT_NE(buffer.front(), nullptr);
+    EXPECT_EQ(*buffer.front(), 1);
+    EXPECT_TRUE(buffer.pop_front([&value](int&& element) { value = element; }));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(buffer.emplace_back(5));
+    EXPECT_EQ(buffer.clear(), 4u);
+    EXPECT_EQ(buffer.front(), nullptr);
+}
+
+TEST(MpmcRingBufferTest, DestroysRemainingElements) {
+    auto shared = std::make_shared<int>(0);
+    {
+        MpmcRingBuffer<std::shared_ptr<int>> buffer{2};
+        EXPECT_TRUE(buffer.push_back(shared));
+        EXPECT_EQ(shared.use_count(), 2);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(MpmcRingBufferTest, KeepsOrderPerProducer) {
+    constexpr size_t producer_count = 4;
+    constexpr size_t per_producer = 100000;
+    MpmcRingBuffer<size_t> buffer{8};
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producer_count; p++)
+        producers.emplace_back([&buffer, p]() {
+            for (size_t i = 0; i < per_producer; i++)
+                while (!buffer.push_back(p * per_producer + i))
+                    std::this_thread::yield();
+        });
+
+    size_t next[producer_count] = {};
+    size_t received = 0;
+    bool ordered = true;
+    while (received < producer_count * per_producer) {
+        bool popped = buffer.pop_front([&](size_t&& value) {
+            auto p = value / per_producer;
+            ordered = ordered && value % per_producer == next[p]++;
+            received++;
+        });
+        if (!popped)
+            std::this_thread::yield();
+    }
+    for (auto& producer : producers)
+        producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(buffer.readable(), 0u);
+}
+
+TEST(MpmcRingBufferTest, HandsEachElementToOneConsumer) {
+    constexpr size_t consumer_count = 4;
+    constexpr size_t total = 100000;
+    MpmcRingBuffer<size_t> buffer{16};
+
+    std::atomic<size_t> sum = 0, received = 0;
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < consumer_count; c++)
+        consumers.emplace_back([&]() {
+            while (received.load(std::memory_order::relaxed) < total) {
+                bool popped = buffer.pop_front([&](size_t&& value) {
+                    sum.fetch_add(value, std::memory_order::relaxed);
+                    received.fetch_add(1, std::memory_order::relaxed);
+                });
+                if (!popped)
+                    std::this_thread::yield();
+            }
+        });
+
+    for (size_t i = 1; i <= total; i++)
+        while (!buffer.push_back(i))
+            std::this_thread::yield();
+    for (auto& consumer : consumers)
+        consumer.join();
+
+    EXPECT_EQ(sum.load(), total * (total + 1) / 2);
+}
+
+} // namespace wujihandcpp::utility